@@ -48,6 +48,13 @@ static int	append_arg_number __ARGS((win_T *wp, char_u *buf, int buflen, int add
 static void	free_buffer __ARGS((buf_T *));
 static void	free_buffer_stuff __ARGS((buf_T *buf, int free_options));
 static void	clear_wininfo __ARGS((buf_T *buf));
+static void	buf_index_init __ARGS((void));
+static void	buf_index_add __ARGS((hashtab_T *ht, bufindex_T *bi, buf_T *buf));
+static void	buf_index_remove __ARGS((hashtab_T *ht, bufindex_T *bi));
+static bufindex_T *buf_index_find __ARGS((hashtab_T *ht, char_u *key));
+#ifdef UNIX
+static void	buf_ino_key __ARGS((dev_t dev, ino_t ino, char_u *key));
+#endif
 
 #ifdef UNIX
 # define dev_T dev_t
@@ -67,6 +74,23 @@ static char *msg_qflist = N_("[Quickfix List]");
 static char *e_auabort = N_("E855: Autocommands caused command to abort");
 #endif
 
+/*
+ * Buffers are indexed by number, by full file name and on Unix by device and
+ * inode number, so that they can be found without going over the whole
+ * buffer list.  Each index is a hashtable with the bufindex_T entries in
+ * buf_T as the items.
+ */
+static hashtab_T buf_nr_ht;
+static hashtab_T buf_name_ht;
+#ifdef UNIX
+static hashtab_T buf_ino_ht;
+#endif
+static int	buf_index_done = FALSE;
+
+/* Used for computing the offset of bi_key in a bufindex_T. */
+static bufindex_T dumbi;
+#define HI2BI(hi)   ((bufindex_T *)((hi)->hi_key - (dumbi.bi_key - (char_u *)&dumbi)))
+
 /*
  * Open current buffer, that is: open the memfile and read the file into
  * memory.
@@ -312,7 +336,9 @@ buf_valid(buf)
 {
     buf_T	*bp;
 
-    for (bp = firstbuf; bp != NULL; bp = bp->b_next)
+    /* Assume that we more often check the recently created buffers, e.g.
+     * after the BufNew autocommands in buflist_new(). */
+    for (bp = lastbuf; bp != NULL; bp = bp->b_prev)
 	if (bp == buf)
 	    return TRUE;
     return FALSE;
@@ -505,6 +531,11 @@ aucmd_abort:
 	if (usingSunWorkShop)
 	    workshop_file_closed_lineno((char *)buf->b_ffname,
 			(int)buf->b_last_cursor.lnum);
+#endif
+	buf_index_remove(&buf_nr_ht, &buf->b_nr_index);
+	buf_index_remove(&buf_name_ht, &buf->b_name_index);
+#ifdef UNIX
+	buf_index_remove(&buf_ino_ht, &buf->b_ino_index);
 #endif
 	vim_free(buf->b_ffname);
 	vim_free(buf->b_sfname);
@@ -728,6 +759,8 @@ free_buffer_stuff(buf, free_options)
 #ifdef FEAT_LOCALMAP
     map_clear_int(buf, MAP_ALL_MODES, TRUE, FALSE);  /* clear local mappings */
     map_clear_int(buf, MAP_ALL_MODES, TRUE, TRUE);   /* clear local abbrevs */
+    hash_clear(&buf->b_maplhs);
+    hash_init(&buf->b_maplhs);
 #endif
 #ifdef FEAT_MBYTE
     vim_free(buf->b_start_fenc);
@@ -1644,6 +1677,238 @@ do_autochdir()
  * functions for dealing with the buffer list
  */
 
+    static void
+buf_index_init()
+{
+    if (!buf_index_done)
+    {
+	hash_init(&buf_nr_ht);
+	hash_init(&buf_name_ht);
+#ifdef UNIX
+	hash_init(&buf_ino_ht);
+#endif
+	buf_index_done = TRUE;
+    }
+}
+
+/*
+ * Add entry "bi" of buffer "buf" to index "ht".  bi->bi_key must be set.
+ */
+    static void
+buf_index_add(ht, bi, buf)
+    hashtab_T	*ht;
+    bufindex_T	*bi;
+    buf_T	*buf;
+{
+    hash_T	hash;
+    hashitem_T	*hi;
+    bufindex_T	*p;
+
+    buf_index_init();
+    bi->bi_buf = buf;
+    bi->bi_next = NULL;
+    hash = hash_hash(bi->bi_key);
+    hi = hash_lookup(ht, bi->bi_key, hash);
+    if (HASHITEM_EMPTY(hi))
+    {
+	if (hash_add_item(ht, hi, bi->bi_key, hash) == FAIL)
+	    bi->bi_key[0] = NUL;
+    }
+    else
+    {
+	/* Append to the buffers with the same key. */
+	for (p = HI2BI(hi); p->bi_next != NULL; p = p->bi_next)
+	    ;
+	p->bi_next = bi;
+    }
+}
+
+/*
+ * Remove entry "bi" from index "ht", if it is in it.
+ */
+    static void
+buf_index_remove(ht, bi)
+    hashtab_T	*ht;
+    bufindex_T	*bi;
+{
+    hashitem_T	*hi;
+    bufindex_T	*p;
+
+    if (bi->bi_key[0] == NUL)
+	return;
+    hi = hash_find(ht, bi->bi_key);
+    if (!HASHITEM_EMPTY(hi))
+    {
+	p = HI2BI(hi);
+	if (p == bi)
+	{
+	    if (bi->bi_next == NULL)
+		hash_remove(ht, hi);
+	    else
+		hi->hi_key = bi->bi_next->bi_key;  /* same key */
+	}
+	else
+	{
+	    for ( ; p->bi_next != NULL; p = p->bi_next)
+		if (p->bi_next == bi)
+		{
+		    p->bi_next = bi->bi_next;
+		    break;
+		}
+	}
+    }
+    bi->bi_key[0] = NUL;
+    bi->bi_next = NULL;
+}
+
+/*
+ * Find the first entry with "key" in index "ht".  Follow bi_next for the
+ * other buffers with the same key.
+ */
+    static bufindex_T *
+buf_index_find(ht, key)
+    hashtab_T	*ht;
+    char_u	*key;
+{
+    hashitem_T	*hi;
+
+    buf_index_init();
+    hi = hash_find(ht, key);
+    if (HASHITEM_EMPTY(hi))
+	return NULL;
+    return HI2BI(hi);
+}
+
+/*
+ * Compute the key for the file name index from full file name "ffname".
+ * Names that fnamecmp() considers equal get the same key, different names
+ * may get the same key too.  With 'fileignorecase' characters are folded the
+ * way mb_strnicmp() does it.  Also used for the visited list of
+ * vim_findfile().
+ */
+    void
+buf_name_key(ffname, key)
+    char_u	*ffname;
+    char_u	*key;	    /* BUFINDEX_KEYLEN bytes */
+{
+    char_u	*p = ffname;
+    hash_T	hash = 0;
+    int		c;
+#ifndef BACKSLASH_IN_FILENAME
+    int		fold = p_fic;
+# ifdef FEAT_MBYTE
+    int		l;
+    size_t	n;
+
+    if (fold && enc_utf8)
+    {
+	/* Like utf_strnicmp(): fold characters, after an illegal or
+	 * incomplete byte sequence the rest is compared byte-wise. */
+	n = STRLEN(p);
+	while ((c = utf_safe_read_char_adv(&p, &n)) > 0)
+	    hash = hash * 101 + (hash_T)utf_fold(c);
+	fold = FALSE;
+    }
+# endif
+#endif
+    while (*p != NUL)
+    {
+#ifdef BACKSLASH_IN_FILENAME
+	c = PTR2CHAR(p);
+	if (p_fic)
+	    c = MB_TOLOWER(c);
+	if (c == '\\')
+	    c = '/';
+	mb_ptr_adv(p);
+#else
+	if (!fold)
+	    c = *p++;
+# ifdef FEAT_MBYTE
+	else if (has_mbyte && (l = (*mb_ptr2len)(p)) > 1)
+	{
+	    /* multi-byte chars are compared as-is */
+	    while (--l > 0 && p[1] != NUL)
+		hash = hash * 101 + (hash_T)*p++;
+	    c = *p++;
+	}
+# endif
+	else
+	    c = MB_TOLOWER(*p++);
+#endif
+	hash = hash * 101 + (hash_T)c;
+    }
+    sprintf((char *)key, "%lx", (long_u)hash);
+}
+
+#ifdef UNIX
+    static void
+buf_ino_key(dev, ino, key)
+    dev_t	dev;
+    ino_t	ino;
+    char_u	*key;	    /* BUFINDEX_KEYLEN bytes */
+{
+    sprintf((char *)key, "%lx:%lx", (long_u)dev, (long_u)ino);
+}
+#endif
+
+/*
+ * Update the file name and dev/inode index entries of "buf".
+ * Must be called when b_ffname, b_dev_valid, b_dev or b_ino changed.
+ */
+    void
+buf_reindex(buf)
+    buf_T	*buf;
+{
+    char_u	key[BUFINDEX_KEYLEN];
+
+    /* A buffer that is not in the buffer list is not indexed. */
+    if (buf->b_nr_index.bi_key[0] == NUL)
+	return;
+
+    if (buf->b_ffname == NULL)
+	key[0] = NUL;
+    else
+	buf_name_key(buf->b_ffname, key);
+    if (STRCMP(key, buf->b_name_index.bi_key) != 0)
+    {
+	buf_index_remove(&buf_name_ht, &buf->b_name_index);
+	if (key[0] != NUL)
+	{
+	    STRCPY(buf->b_name_index.bi_key, key);
+	    buf_index_add(&buf_name_ht, &buf->b_name_index, buf);
+	}
+    }
+
+#ifdef UNIX
+    if (buf->b_ffname == NULL || !buf->b_dev_valid)
+	key[0] = NUL;
+    else
+	buf_ino_key(buf->b_dev, buf->b_ino, key);
+    if (STRCMP(key, buf->b_ino_index.bi_key) != 0)
+    {
+	buf_index_remove(&buf_ino_ht, &buf->b_ino_index);
+	if (key[0] != NUL)
+	{
+	    STRCPY(buf->b_ino_index.bi_key, key);
+	    buf_index_add(&buf_ino_ht, &buf->b_ino_index, buf);
+	}
+    }
+#endif
+}
+
+/*
+ * Update the file name index for all buffers, after 'fileignorecase' was
+ * changed.
+ */
+    void
+buf_reindex_all()
+{
+    buf_T	*buf;
+
+    for (buf = firstbuf; buf != NULL; buf = buf->b_next)
+	buf_reindex(buf);
+}
+
 /*
  * Add a file name to the buffer list.  Return a pointer to the buffer.
  * If the same file name already exists return a pointer to that buffer.
@@ -1839,6 +2104,8 @@ buflist_new(ffname, sfname, lnum, flags)
 	    }
 	    top_file_num = 1;
 	}
+	sprintf((char *)buf->b_nr_index.bi_key, "%x", buf->b_fnum);
+	buf_index_add(&buf_nr_ht, &buf->b_nr_index, buf);
 
 	/*
 	 * Always copy the options from the current buffer.
@@ -1865,6 +2132,7 @@ buflist_new(ffname, sfname, lnum, flags)
 	buf->b_ino = st.st_ino;
     }
 #endif
+    buf_reindex(buf);
     buf->b_u_synced = TRUE;
     buf->b_flags = BF_CHECK_RO | BF_NEVERLOADED;
     if (flags & BLN_DUMMY)
@@ -2195,16 +2463,61 @@ buflist_findname_stat(ffname, stp)
     struct stat	*stp;
 {
 #endif
-    buf_T	*buf;
+    buf_T	*buf = NULL;
+    buf_T	*bp;
+    bufindex_T	*bi;
+    char_u	key[BUFINDEX_KEYLEN];
+
+    /* no name is different */
+    if (ffname == NULL || *ffname == NUL)
+	return NULL;
+
+    /*
+     * Use the indexes instead of going over the buffer list.  When several
+     * buffers match return the first one in the list, which is the one with
+     * the lowest number.
+     */
+    buf_name_key(ffname, key);
+    for (bi = buf_index_find(&buf_name_ht, key); bi != NULL; bi = bi->bi_next)
+    {
+	bp = bi->bi_buf;
+	if ((bp->b_flags & BF_DUMMY) == 0 && bp->b_ffname != NULL
+		&& (buf == NULL || bp->b_fnum < buf->b_fnum)
+		&& fnamecmp(ffname, bp->b_ffname) == 0)
+	    buf = bp;
+    }
 
-    for (buf = firstbuf; buf != NULL; buf = buf->b_next)
-	if ((buf->b_flags & BF_DUMMY) == 0 && !otherfile_buf(buf, ffname
 #ifdef UNIX
-		    , stp
+    /* Also find a buffer for the same file under another name, see
+     * otherfile_buf(). */
+    if (stp->st_dev == (dev_T)-1)
+	return buf;
+    buf_ino_key(stp->st_dev, stp->st_ino, key);
+    bi = buf_index_find(&buf_ino_ht, key);
+    while (bi != NULL)
+    {
+	bp = bi->bi_buf;
+	if ((bp->b_flags & BF_DUMMY) != 0 || bp->b_ffname == NULL
+		|| (buf != NULL && bp->b_fnum >= buf->b_fnum)
+		|| !buf_same_ino(bp, stp))
+	{
+	    bi = bi->bi_next;
+	    continue;
+	}
+
+	/* Get the dev/ino again, the file may have been deleted or renamed.
+	 * When it changed the buffer moved to another key, start over. */
+	buf_setino(bp);
+	if (buf_same_ino(bp, stp))
+	{
+	    buf = bp;
+	    bi = bi->bi_next;
+	}
+	else
+	    bi = buf_index_find(&buf_ino_ht, key);
+    }
 #endif
-		    ))
-	    return buf;
-    return NULL;
+    return buf;
 }
 
 #if defined(FEAT_LISTCMDS) || defined(FEAT_EVAL) || defined(FEAT_PERL) \
@@ -2255,6 +2568,32 @@ buflist_findpat(pattern, pattern_end, unlisted, diffmode, curtab_only)
      */
     else
     {
+	/*
+	 * A full file name without wildcards matches the buffer with that
+	 * name in all attempts below, when it is listed.  Find it in the
+	 * index instead of matching a regexp with every buffer name.
+	 */
+	if (!diffmode && !curtab_only)
+	{
+	    char_u	*name = vim_strnsave(pattern, (int)(pattern_end - pattern));
+#ifdef UNIX
+	    struct stat	st;
+
+	    st.st_dev = (dev_T)-1;	/* only use the name */
+#endif
+	    buf = NULL;
+	    if (name != NULL && mch_isFullName(name)
+			&& vim_strpbrk(name, (char_u *)"*?[{}\\~,^$") == NULL)
+#ifdef UNIX
+		buf = buflist_findname_stat(name, &st);
+#else
+		buf = buflist_findname(name);
+#endif
+	    vim_free(name);
+	    if (buf != NULL && buf->b_p_bl)
+		return buf->b_fnum;
+	}
+
 	pat = file_pat_to_reg_pat(pattern, pattern_end, NULL, FALSE);
 	if (pat == NULL)
 	    return -1;
@@ -2502,14 +2841,14 @@ fname_match(prog, name)
 buflist_findnr(nr)
     int		nr;
 {
-    buf_T	*buf;
+    char_u	key[BUFINDEX_KEYLEN];
+    bufindex_T	*bi;
 
     if (nr == 0)
 	nr = curwin->w_alt_fnum;
-    for (buf = firstbuf; buf != NULL; buf = buf->b_next)
-	if (buf->b_fnum == nr)
-	    return (buf);
-    return NULL;
+    sprintf((char *)key, "%x", nr);
+    bi = buf_index_find(&buf_nr_ht, key);
+    return bi == NULL ? NULL : bi->bi_buf;
 }
 
 /*
@@ -2904,6 +3243,7 @@ setfname(buf, ffname, sfname, message)
 	buf->b_ino = st.st_ino;
     }
 #endif
+    buf_reindex(buf);
 
 #ifndef SHORT_FNAME
     buf->b_shortname = FALSE;
@@ -2935,6 +3275,7 @@ buf_set_name(fnum, name)
 	 * files on Win32. */
 	fname_expand(buf, &buf->b_ffname, &buf->b_sfname);
 	buf->b_fname = buf->b_sfname;
+	buf_reindex(buf);
     }
 }
 
@@ -3136,6 +3477,7 @@ buf_setino(buf)
     }
     else
 	buf->b_dev_valid = FALSE;
+    buf_reindex(buf);
 }
 
 /*
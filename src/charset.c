@@ -793,7 +793,9 @@ vim_strnsize(s, len)
     while (*s != NUL && --len >= 0)
     {
 #ifdef FEAT_MBYTE
-	if (has_mbyte)
+	/* An ASCII byte is always a single character, skip the function
+	 * pointer calls for it. */
+	if (has_mbyte && *s >= 0x80)
 	{
 	    int	    l = (*mb_ptr2len)(s);
 
@@ -869,9 +871,27 @@ linetabsize_col(startcol, s)
     colnr_T	col = startcol;
     char_u	*line = s; /* pointer to start of line, for breakindent */
 
+#ifdef FEAT_LINEBREAK
+    if (!curwin->w_p_lbr && *p_sbr == NUL && !curwin->w_p_bri)
+#endif
+    {
+	/* Without 'linebreak', 'showbreak' and 'breakindent' the size of an
+	 * ASCII character other than a TAB only depends on the character
+	 * itself. */
+	while (*s != NUL)
+	{
+	    if (*s < 0x80 && *s != TAB)
+		col += CHARSIZE(*s++);
+	    else
+		col += lbr_chartabsize_adv(line, &s, col);
+	}
+	return (int)col;
+    }
+#ifdef FEAT_LINEBREAK
     while (*s != NUL)
 	col += lbr_chartabsize_adv(line, &s, col);
     return (int)col;
+#endif
 }
 
 /*
@@ -1362,7 +1382,12 @@ getvcol(wp, pos, start, cursor, end)
 		break;
 
 	    vcol += incr;
-	    mb_ptr_adv(ptr);
+#ifdef FEAT_MBYTE
+	    if (c < 0x80)
+		++ptr;	/* ASCII is always a single byte */
+	    else
+#endif
+		mb_ptr_adv(ptr);
 	}
     }
     else
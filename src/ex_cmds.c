@@ -269,10 +269,12 @@ linelen(has_tab)
     return len;
 }
 
-/* Buffer for two lines used during sorting.  They are allocated to
- * contain the longest line being sorted. */
+/* Buffer for a line used during sorting.  It is allocated to contain the
+ * longest line being sorted. */
 static char_u	*sortbuf1;
-static char_u	*sortbuf2;
+
+/* The sort keys of all lines, each one terminated with a NUL. */
+static char_u	*sortkeys;
 
 static int	sort_ic;		/* ignore case */
 static int	sort_nr;		/* sort on number */
@@ -284,7 +286,8 @@ static int	sort_abort;		/* flag to indicate if sorting has been interrupted */
 typedef struct
 {
     linenr_T	lnum;			/* line number */
-    long	start_col_nr;		/* starting column number or number */
+    long	start_col_nr;		/* starting column number or number,
+					   offset in "sortkeys" when sorted */
     long	end_col_nr;		/* ending column number */
 } sorti_T;
 
@@ -321,20 +324,12 @@ sort_compare(s1, s2)
 	result = l1.start_col_nr == l2.start_col_nr ? 0
 				 : l1.start_col_nr > l2.start_col_nr ? 1 : -1;
     else
-    {
-	/* We need to copy one line into "sortbuf1", because there is no
-	 * guarantee that the first pointer becomes invalid when obtaining the
-	 * second one. */
-	STRNCPY(sortbuf1, ml_get(l1.lnum) + l1.start_col_nr,
-					 l1.end_col_nr - l1.start_col_nr + 1);
-	sortbuf1[l1.end_col_nr - l1.start_col_nr] = 0;
-	STRNCPY(sortbuf2, ml_get(l2.lnum) + l2.start_col_nr,
-					 l2.end_col_nr - l2.start_col_nr + 1);
-	sortbuf2[l2.end_col_nr - l2.start_col_nr] = 0;
-
-	result = sort_ic ? STRICMP(sortbuf1, sortbuf2)
-						 : STRCMP(sortbuf1, sortbuf2);
-    }
+	/* The keys were copied into "sortkeys" before sorting, so that the
+	 * lines don't need to be obtained with ml_get() for every
+	 * comparison. */
+	result = sort_ic
+		? STRICMP(sortkeys + l1.start_col_nr, sortkeys + l2.start_col_nr)
+		: STRCMP(sortkeys + l1.start_col_nr, sortkeys + l2.start_col_nr);
 
     /* If two lines have the same value, preserve the original line order. */
     if (result == 0)
@@ -356,6 +351,8 @@ ex_sort(eap)
     sorti_T	*nrs;
     size_t	count = (size_t)(eap->line2 - eap->line1 + 1);
     size_t	i;
+    long_u	keylen = 0;
+    sorti_T	*nrp;
     char_u	*p;
     char_u	*s;
     char_u	*s2;
@@ -374,7 +371,7 @@ ex_sort(eap)
     if (u_save((linenr_T)(eap->line1 - 1), (linenr_T)(eap->line2 + 1)) == FAIL)
 	return;
     sortbuf1 = NULL;
-    sortbuf2 = NULL;
+    sortkeys = NULL;
     regmatch.regprog = NULL;
     nrs = (sorti_T *)lalloc((long_u)(count * sizeof(sorti_T)), TRUE);
     if (nrs == NULL)
@@ -507,6 +504,7 @@ ex_sort(eap)
 	    /* Store the column to sort at. */
 	    nrs[lnum - eap->line1].start_col_nr = start_col;
 	    nrs[lnum - eap->line1].end_col_nr = end_col;
+	    keylen += end_col - start_col + 1;
 	}
 
 	nrs[lnum - eap->line1].lnum = lnum;
@@ -521,9 +519,26 @@ ex_sort(eap)
     sortbuf1 = alloc((unsigned)maxlen + 1);
     if (sortbuf1 == NULL)
 	goto sortend;
-    sortbuf2 = alloc((unsigned)maxlen + 1);
-    if (sortbuf2 == NULL)
-	goto sortend;
+
+    if (!sort_nr)
+    {
+	/* Copy the part of each line to sort on into "sortkeys", one after
+	 * the other.  From here on "start_col_nr" is the offset of the key. */
+	sortkeys = lalloc(keylen, TRUE);
+	if (sortkeys == NULL)
+	    goto sortend;
+	keylen = 0;
+	for (i = 0; i < count; ++i)
+	{
+	    nrp = &nrs[i];
+	    len = (int)(nrp->end_col_nr - nrp->start_col_nr);
+	    mch_memmove(sortkeys + keylen,
+			       ml_get(nrp->lnum) + nrp->start_col_nr, (size_t)len);
+	    sortkeys[keylen + len] = NUL;
+	    nrp->start_col_nr = (long)keylen;
+	    keylen += len + 1;
+	}
+    }
 
     /* Sort the array of line numbers.  Note: can't be interrupted! */
     qsort((void *)nrs, count, sizeof(sorti_T), sort_compare);
@@ -570,7 +585,7 @@ ex_sort(eap)
 sortend:
     vim_free(nrs);
     vim_free(sortbuf1);
-    vim_free(sortbuf2);
+    vim_free(sortkeys);
     vim_regfree(regmatch.regprog);
     if (got_int)
 	EMSG(_(e_interr));
@@ -2711,6 +2726,8 @@ do_write(eap)
 	    fname = alt_buf->b_sfname;
 	    alt_buf->b_sfname = curbuf->b_sfname;
 	    curbuf->b_sfname = fname;
+	    buf_reindex(curbuf);
+	    buf_reindex(alt_buf);
 	    buf_name_changed(curbuf);
 #ifdef FEAT_AUTOCMD
 	    apply_autocmds(EVENT_BUFFILEPOST, NULL, NULL, FALSE, curbuf);
@@ -6449,7 +6466,7 @@ ex_viusage(eap)
 }
 
 #if defined(FEAT_EX_EXTRA) || defined(PROTO)
-static void helptags_one __ARGS((char_u *dir, char_u *ext, char_u *lang, int add_help_tags));
+static void helptags_one __ARGS((char_u *dir, char_u *ext, char_u *lang, int add_help_tags, int filecount, char_u **files));
 
 /*
  * ":helptags"
@@ -6489,8 +6506,9 @@ ex_helptags(eap)
 	return;
     }
 
-#ifdef FEAT_MULTI_LANG
-    /* Get a list of all files in the help directory and in subdirectories. */
+    /* Get a list of all files in the help directory and in subdirectories.
+     * The directory tree is only scanned once, also when there are several
+     * languages. */
     STRCPY(NameBuff, dirname);
     add_pathsep(NameBuff);
     STRCAT(NameBuff, "**");
@@ -6503,6 +6521,7 @@ ex_helptags(eap)
 	return;
     }
 
+#ifdef FEAT_MULTI_LANG
     /* Go over all files in the directory to find out what languages are
      * present. */
     ga_init2(&ga, 1, 10);
@@ -6565,37 +6584,39 @@ ex_helptags(eap)
 	    ext[1] = fname[5];
 	    ext[2] = fname[6];
 	}
-	helptags_one(dirname, ext, fname, add_help_tags);
+	helptags_one(dirname, ext, fname, add_help_tags, filecount, files);
     }
 
     ga_clear(&ga);
-    FreeWild(filecount, files);
-
 #else
     /* No language support, just use "*.txt" and "tags". */
-    helptags_one(dirname, (char_u *)".txt", (char_u *)"tags", add_help_tags);
+    helptags_one(dirname, (char_u *)".txt", (char_u *)"tags", add_help_tags,
+							     filecount, files);
 #endif
+    FreeWild(filecount, files);
     vim_free(dirname);
 }
 
     static void
-helptags_one(dir, ext, tagfname, add_help_tags)
+helptags_one(dir, ext, tagfname, add_help_tags, filecount, files)
     char_u	*dir;		/* doc directory */
     char_u	*ext;		/* suffix, ".txt", ".itx", ".frx", etc. */
     char_u	*tagfname;	/* "tags" for English, "tags-fr" for French. */
     int		add_help_tags;	/* add "help-tags" tag */
+    int		filecount;	/* number of files in "files" */
+    char_u	**files;	/* all files in "dir" and its subdirectories */
 {
     FILE	*fd_tags;
     FILE	*fd;
     garray_T	ga;
-    int		filecount;
-    char_u	**files;
     char_u	*p1, *p2;
     int		fi;
     char_u	*s;
     int		i;
     char_u	*fname;
     int		dirlen;
+    int		extlen;
+    int		len;
 # ifdef FEAT_MBYTE
     int		utf8 = MAYBE;
     int		this_utf8;
@@ -6604,16 +6625,21 @@ helptags_one(dir, ext, tagfname, add_help_tags)
 # endif
 
     /*
-     * Find all *.txt files.
+     * Check there is at least one *.txt file.
      */
     dirlen = (int)STRLEN(dir);
-    STRCPY(NameBuff, dir);
-    STRCAT(NameBuff, "/**/*");
-    STRCAT(NameBuff, ext);
-    if (gen_expand_wildcards(1, &NameBuff, &filecount, &files,
-						    EW_FILE|EW_SILENT) == FAIL
-	    || filecount == 0)
+    extlen = (int)STRLEN(ext);
+    for (fi = 0; fi < filecount; ++fi)
+    {
+	len = (int)STRLEN(files[fi]);
+	if (len > extlen && fnamecmp(files[fi] + len - extlen, ext) == 0)
+	    break;
+    }
+    if (fi == filecount)
     {
+	STRCPY(NameBuff, dir);
+	STRCAT(NameBuff, "/**/*");
+	STRCAT(NameBuff, ext);
 	if (!got_int)
 	    EMSG2("E151: No match: %s", NameBuff);
 	return;
@@ -6630,7 +6656,6 @@ helptags_one(dir, ext, tagfname, add_help_tags)
     if (fd_tags == NULL)
     {
 	EMSG2(_("E152: Cannot open %s for writing"), NameBuff);
-	FreeWild(filecount, files);
 	return;
     }
 
@@ -6663,6 +6688,9 @@ helptags_one(dir, ext, tagfname, add_help_tags)
      */
     for (fi = 0; fi < filecount && !got_int; ++fi)
     {
+	len = (int)STRLEN(files[fi]);
+	if (len <= extlen || fnamecmp(files[fi] + len - extlen, ext) != 0)
+	    continue;
 	fd = mch_fopen((char *)files[fi], "r");
 	if (fd == NULL)
 	{
@@ -6761,8 +6789,6 @@ helptags_one(dir, ext, tagfname, add_help_tags)
 	fclose(fd);
     }
 
-    FreeWild(filecount, files);
-
     if (!got_int)
     {
 	/*
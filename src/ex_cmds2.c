@@ -2813,6 +2813,23 @@ source_runtime(name, all)
     char_u	*name;
     int		all;
 {
+#ifdef STARTUPTIME
+    struct timeval  tv_rel;
+    struct timeval  tv_start;
+    int		    retval;
+
+    /* The "self" time is the time spent searching 'runtimepath'. */
+    if (time_fd != NULL)
+    {
+	time_push(&tv_rel, &tv_start);
+	retval = do_in_runtimepath(name, all, source_callback, NULL);
+	vim_snprintf((char *)IObuff, IOSIZE, "runtime%s %s",
+							 all ? "!" : "", name);
+	time_msg((char *)IObuff, &tv_start);
+	time_pop(&tv_rel);
+	return retval;
+    }
+#endif
     return do_in_runtimepath(name, all, source_callback, NULL);
 }
 
@@ -2843,6 +2860,11 @@ do_in_runtimepath(name, all, callback, cookie)
     char_u	**files;
     int		i;
     int		did_one = FALSE;
+    char_u	*p;
+    char_u	dir_name[100];
+    int		dir_len;
+    int		dir_ok = TRUE;
+    int		entry_wild;
 #ifdef AMIGA
     struct Process	*proc = (struct Process *)FindTask(0L);
     APTR		save_winptr = proc->pr_WindowPtr;
@@ -2879,8 +2901,11 @@ do_in_runtimepath(name, all, callback, cookie)
 	    }
 	    else if (STRLEN(buf) + STRLEN(name) + 2 < MAXPATHL)
 	    {
+		/* An entry with wildcards can't be checked with mch_isdir(). */
+		entry_wild = mch_has_wildcard(buf);
 		add_pathsep(buf);
 		tail = buf + STRLEN(buf);
+		dir_len = -1;
 
 		/* Loop over all patterns in "name" */
 		np = name;
@@ -2890,6 +2915,28 @@ do_in_runtimepath(name, all, callback, cookie)
 		    copy_option_part(&np, tail, (int)(MAXPATHL - (tail - buf)),
 								       "\t ");
 
+		    /* The patterns usually start with the same directory, e.g.
+		     * "ftplugin/".  Check once if it exists in this entry,
+		     * instead of expanding each pattern. */
+		    for (p = tail; *p != NUL && *p != '/'
+			       && vim_strchr((char_u *)"*?[{~$\\`'", *p) == NULL; ++p)
+			;
+		    if (!entry_wild && *p == '/'
+					       && p - tail < (int)sizeof(dir_name))
+		    {
+			if (p - tail != dir_len
+				   || STRNCMP(tail, dir_name, dir_len) != 0)
+			{
+			    dir_len = (int)(p - tail);
+			    vim_strncpy(dir_name, tail, dir_len);
+			    *p = NUL;
+			    dir_ok = mch_isdir(buf);
+			    *p = '/';
+			}
+			if (!dir_ok)
+			    continue;
+		    }
+
 		    if (p_verbose > 2)
 		    {
 			verbose_enter();
@@ -1740,7 +1740,13 @@ retry:
 	    }
 	    else
 # endif
-	    if (fio_flags != 0)
+	    if ((fio_flags == FIO_LATIN1 || fio_flags == FIO_UTF8)
+					&& utf_ascii_len(ptr, (int)size) == size)
+	    {
+		/* Only ASCII, which is the same in Latin1 and UTF-8: there is
+		 * nothing to convert and the text can stay where it is. */
+	    }
+	    else if (fio_flags != 0)
 	    {
 		int	u8c;
 		char_u	*dest;
@@ -1923,8 +1929,13 @@ retry:
 		    }
 		    if (enc_utf8)	/* produce UTF-8 */
 		    {
-			dest -= utf_char2len(u8c);
-			(void)utf_char2bytes(u8c, dest);
+			if (u8c < 0x80)
+			    *--dest = u8c;
+			else
+			{
+			    dest -= utf_char2len(u8c);
+			    (void)utf_char2bytes(u8c, dest);
+			}
 		    }
 		    else		/* produce Latin1 */
 		    {
@@ -2025,6 +2036,13 @@ retry:
 			else
 			    p += l - 1;
 		    }
+		    else
+		    {
+			/* ASCII is always valid, skip over a run of it. */
+			l = utf_ascii_len(p, todo);
+			if (l > 1)
+			    p += l - 1;
+		    }
 		}
 		if (p < ptr + size && !incomplete_tail)
 		{
@@ -5408,7 +5426,12 @@ buf_write_bytes(ip)
 	     */
 	    p = ip->bw_conv_buf;	/* translate to buffer */
 	    for (wlen = 0; wlen < len; ++wlen)
-		p += utf_char2bytes(buf[wlen], p);
+	    {
+		if (buf[wlen] < 0x80)
+		    *p++ = buf[wlen];
+		else
+		    p += utf_char2bytes(buf[wlen], p);
+	    }
 	    buf = ip->bw_conv_buf;
 	    len = (int)(p - ip->bw_conv_buf);
 	}
@@ -5463,6 +5486,18 @@ buf_write_bytes(ip)
 			n = 0;
 		    }
 		}
+		else if ((flags & FIO_LATIN1) && buf[wlen] < 0x80)
+		{
+		    /* ASCII is the same in Latin1, copy a run of it without
+		     * decoding each character. */
+		    for (n = 0; wlen + n < len && buf[wlen + n] < 0x80; ++n)
+		    {
+			if (buf[wlen + n] == NL)
+			    ++ip->bw_start_lnum;
+			*p++ = buf[wlen + n];
+		    }
+		    continue;
+		}
 		else
 		{
 		    n = utf_ptr2len_len(buf + wlen, len - wlen);
@@ -7706,8 +7741,19 @@ typedef struct AutoPat
     int		    buflocal_nr;	/* !=0 for buffer-local AutoPat */
     char	    allow_dirs;		/* Pattern may match whole path */
     char	    last;		/* last pattern for apply_autocmds() */
+    char	    fastmatch;		/* AP_ value: how to match without
+					   reg_prog */
+    char_u	    *fastpat;		/* literal part of pat for fastmatch */
 } AutoPat;
 
+/* Values for AutoPat.fastmatch.  Many patterns are like "*" or "*.ext", for
+ * those comparing the tail of the file name is much faster than running the
+ * regexp. */
+#define AP_REGEXP	0	/* use reg_prog */
+#define AP_ANY		1	/* "*": matches any file name */
+#define AP_SUFFIX	2	/* "*lit": tail ends in fastpat */
+#define AP_EXACT	3	/* "lit": tail is fastpat */
+
 static struct event_name
 {
     char	*name;	/* event name */
@@ -7859,6 +7905,8 @@ static int au_get_grouparg __ARGS((char_u **argp));
 static int do_autocmd_event __ARGS((event_T event, char_u *pat, int nested, char_u *cmd, int forceit, int group));
 static int apply_autocmds_group __ARGS((event_T event, char_u *fname, char_u *fname_io, int force, int group, buf_T *buf, exarg_T *eap));
 static void auto_next_pat __ARGS((AutoPatCmd *apc, int stop_at_last));
+static void au_set_fastmatch __ARGS((AutoPat *ap));
+static int au_match_fname __ARGS((AutoPat *ap, char_u *fname, char_u *sfname, char_u *tail));
 
 
 static event_T	last_event;
@@ -8713,6 +8761,7 @@ do_autocmd_event(event, pat, nested, cmd, forceit, group)
 		    return FAIL;
 		}
 
+		ap->fastmatch = AP_REGEXP;
 		if (is_buflocal)
 		{
 		    ap->buflocal_nr = buflocal_nr;
@@ -8734,6 +8783,7 @@ do_autocmd_event(event, pat, nested, cmd, forceit, group)
 			vim_free(ap);
 			return FAIL;
 		    }
+		    au_set_fastmatch(ap);
 		}
 		ap->cmds = NULL;
 		*prev_ap = ap;
@@ -9293,6 +9343,10 @@ apply_autocmds_group(event, fname, fname_io, force, group, buf, eap)
 #ifdef FEAT_PROFILE
     proftime_T	wait_time;
 #endif
+#ifdef STARTUPTIME
+    struct timeval	tv_rel;
+    struct timeval	tv_start;
+#endif
 
     /*
      * Quickly return if there are no autocommands for this event or
@@ -9547,8 +9601,21 @@ apply_autocmds_group(event, fname, fname_io, force, group, buf, eap)
 	    ap->last = FALSE;
 	ap->last = TRUE;
 	check_lnums(TRUE);	/* make sure cursor and topline are valid */
+#ifdef STARTUPTIME
+	if (time_fd != NULL)
+	    time_push(&tv_rel, &tv_start);
+#endif
 	do_cmdline(NULL, getnextac, (void *)&patcmd,
 				     DOCMD_NOWAIT|DOCMD_VERBOSE|DOCMD_REPEAT);
+#ifdef STARTUPTIME
+	if (time_fd != NULL)
+	{
+	    vim_snprintf((char *)IObuff, IOSIZE, "%s autocommands for \"%s\"",
+					       event_nr2name(event), fname);
+	    time_msg((char *)IObuff, &tv_start);
+	    time_pop(&tv_rel);
+	}
+#endif
 #ifdef FEAT_EVAL
 	if (eap != NULL)
 	{
@@ -9706,8 +9773,7 @@ auto_next_pat(apc, stop_at_last)
 	{
 	    /* execution-condition */
 	    if (ap->buflocal_nr == 0
-		    ? (match_file_pat(NULL, ap->reg_prog, apc->fname,
-				      apc->sfname, apc->tail, ap->allow_dirs))
+		    ? au_match_fname(ap, apc->fname, apc->sfname, apc->tail)
 		    : ap->buflocal_nr == apc->arg_bufnr)
 	    {
 		name = event_nr2name(apc->event);
@@ -9742,6 +9808,82 @@ auto_next_pat(apc, stop_at_last)
     }
 }
 
+/*
+ * Check if the file pattern of "ap" can be matched without the regexp: "*",
+ * "*lit" or "lit" where "lit" only contains letters, digits and "._-+".
+ * Sets ap->fastmatch and ap->fastpat.
+ */
+    static void
+au_set_fastmatch(ap)
+    AutoPat	*ap;
+{
+    char_u	*p = ap->pat;
+    int		kind = AP_EXACT;
+
+    ap->fastmatch = AP_REGEXP;
+    if (ap->allow_dirs)
+	return;
+    if (*p == '*')
+    {
+	while (*p == '*')
+	    ++p;
+	if (*p == NUL)
+	{
+	    ap->fastmatch = AP_ANY;
+	    return;
+	}
+	kind = AP_SUFFIX;
+    }
+    ap->fastpat = p;
+    for ( ; *p != NUL; ++p)
+	if (!ASCII_ISALNUM(*p) && vim_strchr((char_u *)"._-+", *p) == NULL)
+	    return;
+    ap->fastmatch = kind;
+}
+
+/*
+ * Return TRUE if the file pattern of "ap" matches the file name.
+ */
+    static int
+au_match_fname(ap, fname, sfname, tail)
+    AutoPat	*ap;
+    char_u	*fname;
+    char_u	*sfname;
+    char_u	*tail;
+{
+    if (ap->fastmatch == AP_ANY)
+	return TRUE;
+    if (ap->fastmatch != AP_REGEXP && tail != NULL
+#ifdef FEAT_MBYTE
+	    /* a trail byte of a double-byte char may look like ASCII */
+	    && enc_dbcs == 0
+#endif
+	    )
+    {
+	int	len = (int)STRLEN(tail);
+	int	plen = ap->patlen - (int)(ap->fastpat - ap->pat);
+	char_u	*p;
+
+	if (ap->fastmatch == AP_EXACT ? len != plen : len < plen)
+	{
+	    if (!p_fic)
+		return FALSE;
+	}
+	else if (!p_fic)
+	    return STRCMP(tail + len - plen, ap->fastpat) == 0;
+
+	/* When ignoring case a non-ASCII char may match an ASCII one, use
+	 * the regexp then. */
+	for (p = tail; *p != NUL && *p < 0x80; ++p)
+	    ;
+	if (*p == NUL)
+	    return len >= plen && (ap->fastmatch == AP_SUFFIX || len == plen)
+			    && STRICMP(tail + len - plen, ap->fastpat) == 0;
+    }
+    return match_file_pat(NULL, ap->reg_prog, fname, sfname, tail,
+							      ap->allow_dirs);
+}
+
 /*
  * Get next autocommand command.
  * Called by do_cmdline() to get the next line for ":if".
@@ -9840,8 +9982,7 @@ has_autocmd(event, sfname, buf)
     for (ap = first_autopat[(int)event]; ap != NULL; ap = ap->next)
 	if (ap->pat != NULL && ap->cmds != NULL
 	      && (ap->buflocal_nr == 0
-		? match_file_pat(NULL, ap->reg_prog,
-					  fname, sfname, tail, ap->allow_dirs)
+		? au_match_fname(ap, fname, sfname, tail)
 		: buf != NULL && ap->buflocal_nr == buf->b_fnum
 	   ))
 	{
@@ -76,6 +76,25 @@ static int		maphash_valid = FALSE;
  */
 static mapblock_T	*first_abbr = NULL; /* first entry in abbrlist */
 
+/*
+ * For every table of mappings a hashtable counts the entries with the same
+ * {lhs}.  ":map" uses it to find out quickly that a new mapping does not
+ * replace an existing one, so that it doesn't have to go over all mappings.
+ * Abbreviations are not counted.
+ */
+typedef struct
+{
+    int		ml_count;	/* number of mappings with this {lhs} */
+    char_u	ml_key[1];	/* {lhs}, actually longer (NUL terminated) */
+} maplhs_T;
+
+static maplhs_T		dumml;
+#define HI2ML(hi)	((maplhs_T *)((hi)->hi_key - (dumml.ml_key - (char_u *)&dumml)))
+
+static hashtab_T	maplhs;		/* {lhs} counts for maphash[] */
+static int		maplhs_failed = FALSE; /* out of memory, counts
+						  can't be trusted */
+
 static int		KeyNoremap = 0;	    /* remapping flags */
 
 /*
@@ -126,7 +145,10 @@ static void	gotchars __ARGS((char_u *, int));
 static void	may_sync_undo __ARGS((void));
 static void	closescript __ARGS((void));
 static int	vgetorpeek __ARGS((int));
-static void	map_free __ARGS((mapblock_T **));
+static void	map_lhs_add __ARGS((hashtab_T *ht, char_u *keys));
+static void	map_lhs_remove __ARGS((hashtab_T *ht, char_u *keys));
+static int	map_lhs_count __ARGS((hashtab_T *ht, char_u *keys));
+static void	map_free __ARGS((mapblock_T **, hashtab_T *ht));
 static void	validate_maphash __ARGS((void));
 static void	showmap __ARGS((mapblock_T *mp, int local));
 #ifdef FEAT_EVAL
@@ -2203,12 +2225,16 @@ vgetorpeek(advance)
 				/* Don't allow mapping the first byte(s) of a
 				 * multi-byte char.  Happens when mapping
 				 * <M-a> and then changing 'encoding'. Beware
-				 * that 0x80 is escaped. */
+				 * that 0x80 is escaped.  Only needed when
+				 * "mlen" is going to be used below. */
+				if (has_mbyte && (mlen == mp->m_keylen
+					    || mlen == typebuf.tb_len
+					    || mlen > max_mlen))
 				{
 				    char_u *p1 = mp->m_keys;
 				    char_u *p2 = mb_unescape(&p1);
 
-				    if (has_mbyte && p2 != NULL
+				    if (p2 != NULL
 					  && MB_BYTE2LEN(c1) > MB_PTR2LEN(p2))
 					mlen = 0;
 				}
@@ -3244,6 +3270,7 @@ do_map(maptype, arg, mode, abbrev)
     int		new_hash;
     mapblock_T	**abbr_table;
     mapblock_T	**map_table;
+    hashtab_T	*lhs_table;
     int		unique = FALSE;
     int		nowait = FALSE;
     int		silent = FALSE;
@@ -3256,6 +3283,7 @@ do_map(maptype, arg, mode, abbrev)
 
     keys = arg;
     map_table = maphash;
+    lhs_table = &maplhs;
     abbr_table = &first_abbr;
 
     /* For ":noremap" don't remap, otherwise do remap. */
@@ -3276,6 +3304,7 @@ do_map(maptype, arg, mode, abbrev)
 	{
 	    keys = skipwhite(keys + 8);
 	    map_table = curbuf->b_maphash;
+	    lhs_table = &curbuf->b_maplhs;
 	    abbr_table = &curbuf->b_first_abbr;
 	    continue;
 	}
@@ -3477,7 +3506,8 @@ do_map(maptype, arg, mode, abbrev)
     /*
      * Check if a new local mapping wasn't already defined globally.
      */
-    if (map_table == curbuf->b_maphash && haskey && hasarg && maptype != 1)
+    if (map_table == curbuf->b_maphash && haskey && hasarg && maptype != 1
+								    && unique)
     {
 	/* need to loop over all global hash lists */
 	for (hash = 0; hash < 256 && !got_int; ++hash)
@@ -3560,10 +3590,16 @@ do_map(maptype, arg, mode, abbrev)
      * entry with a matching 'to' part. This was done to allow ":ab foo bar"
      * to be unmapped by typing ":unab foo", where "foo" will be replaced by
      * "bar" because of the abbreviation.
+     * When adding a mapping only an entry with the same {lhs} matters, no
+     * need to go over all the lists if there is none.
      */
     for (round = 0; (round == 0 || maptype == 1) && round <= 1
 					      && !did_it && !got_int; ++round)
     {
+	if (haskey && hasarg && maptype != 1 && !abbrev
+				      && map_lhs_count(lhs_table, keys) == 0)
+	    break;
+
 	/* need to loop over all hash lists */
 	for (hash = 0; hash < 256 && !got_int; ++hash)
 	{
@@ -3669,7 +3705,7 @@ do_map(maptype, arg, mode, abbrev)
 			}
 			if (mp->m_mode == 0)	/* entry can be deleted */
 			{
-			    map_free(mpp);
+			    map_free(mpp, abbrev ? NULL : lhs_table);
 			    continue;		/* continue with *mpp */
 			}
 
@@ -3765,6 +3801,7 @@ do_map(maptype, arg, mode, abbrev)
 	n = MAP_HASH(mp->m_mode, mp->m_keys[0]);
 	mp->m_next = map_table[n];
 	map_table[n] = mp;
+	map_lhs_add(lhs_table, mp->m_keys);
     }
 
 theend:
@@ -3773,17 +3810,113 @@ theend:
     return retval;
 }
 
+/*
+ * Count one more mapping with {lhs} "keys" in hashtable "ht".
+ * When out of memory the mapping isn't counted, map_lhs_count() then returns
+ * -1 from now on.
+ */
+    static void
+map_lhs_add(ht, keys)
+    hashtab_T	*ht;
+    char_u	*keys;
+{
+    hash_T	hash;
+    hashitem_T	*hi;
+    maplhs_T	*ml;
+
+    if (ht->ht_mask == 0)
+	hash_init(ht);
+    hash = hash_hash(keys);
+    hi = hash_lookup(ht, keys, hash);
+    if (!HASHITEM_EMPTY(hi))
+    {
+	++HI2ML(hi)->ml_count;
+	return;
+    }
+    ml = (maplhs_T *)alloc((unsigned)(sizeof(maplhs_T) + STRLEN(keys)));
+    if (ml == NULL || hash_add_item(ht, hi, ml->ml_key, hash) == FAIL)
+    {
+	vim_free(ml);
+	maplhs_failed = TRUE;
+	return;
+    }
+    STRCPY(ml->ml_key, keys);
+    ml->ml_count = 1;
+}
+
+/*
+ * Count one mapping with {lhs} "keys" less in hashtable "ht".
+ */
+    static void
+map_lhs_remove(ht, keys)
+    hashtab_T	*ht;
+    char_u	*keys;
+{
+    hashitem_T	*hi;
+    maplhs_T	*ml;
+
+    if (ht->ht_mask == 0)
+	return;
+    hi = hash_find(ht, keys);
+    if (HASHITEM_EMPTY(hi))
+	return;
+    ml = HI2ML(hi);
+    if (--ml->ml_count <= 0)
+    {
+	hash_remove(ht, hi);
+	vim_free(ml);
+    }
+}
+
+/*
+ * Return the number of mappings with {lhs} "keys" in hashtable "ht".
+ * Returns -1 when not known.
+ */
+    static int
+map_lhs_count(ht, keys)
+    hashtab_T	*ht;
+    char_u	*keys;
+{
+    hashitem_T	*hi;
+
+    if (maplhs_failed)
+	return -1;
+    if (ht->ht_mask == 0)
+	return 0;
+    hi = hash_find(ht, keys);
+    if (HASHITEM_EMPTY(hi))
+	return 0;
+    return HI2ML(hi)->ml_count;
+}
+
+#if defined(EXITFREE) || defined(PROTO)
+/*
+ * Free the {lhs} counts of global mappings.  Those of buffer-local mappings
+ * are freed with the buffer.
+ */
+    void
+free_map_lhs()
+{
+    hash_clear_all(&maplhs, (int)(dumml.ml_key - (char_u *)&dumml));
+    hash_init(&maplhs);
+}
+#endif
+
 /*
  * Delete one entry from the abbrlist or maphash[].
  * "mpp" is a pointer to the m_next field of the PREVIOUS entry!
+ * "ht" is the {lhs} hashtable for the entry, NULL for an abbreviation.
  */
     static void
-map_free(mpp)
+map_free(mpp, ht)
     mapblock_T	**mpp;
+    hashtab_T	*ht;
 {
     mapblock_T	*mp;
 
     mp = *mpp;
+    if (ht != NULL)
+	map_lhs_remove(ht, mp->m_keys);
     vim_free(mp->m_keys);
     vim_free(mp->m_str);
     vim_free(mp->m_orig_str);
@@ -3893,8 +4026,18 @@ map_clear_int(buf, mode, local, abbr)
     mapblock_T	*mp, **mpp;
     int		hash;
     int		new_hash;
+    hashtab_T	*lhs_table = NULL;
 
     validate_maphash();
+    if (!abbr)
+    {
+#ifdef FEAT_LOCALMAP
+	if (local)
+	    lhs_table = &buf->b_maplhs;
+	else
+#endif
+	    lhs_table = &maplhs;
+    }
 
     for (hash = 0; hash < 256; ++hash)
     {
@@ -3926,7 +4069,7 @@ map_clear_int(buf, mode, local, abbr)
 		mp->m_mode &= ~mode;
 		if (mp->m_mode == 0) /* entry can be deleted */
 		{
-		    map_free(mpp);
+		    map_free(mpp, lhs_table);
 		    continue;
 		}
 		/*
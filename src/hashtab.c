@@ -29,8 +29,6 @@
 
 #include "vim.h"
 
-#if defined(FEAT_EVAL) || defined(FEAT_SYN_HL) || defined(PROTO)
-
 #if 0
 # define HT_DEBUG	/* extra checks for table consistency  and statistics */
 
@@ -499,5 +497,3 @@ hash_hash(key)
 
     return hash;
 }
-
-#endif
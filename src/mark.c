@@ -1641,6 +1641,127 @@ write_one_mark(fp_out, c, pos)
 	fprintf(fp_out, "\t%c\t%ld\t%d\n", c, (long)pos->lnum, (int)pos->col);
 }
 
+/*
+ * Buffers by their home_replace()'d name.  Used by copy_viminfo_marks() to
+ * find the buffer for a file in the viminfo file, without going over all
+ * buffers for every file.
+ */
+typedef struct vimarkbuf_S vimarkbuf_T;
+struct vimarkbuf_S
+{
+    char_u	vb_key[BUFINDEX_KEYLEN]; /* key in the hashtable */
+    vimarkbuf_T	*vb_next;	/* next entry with the same key */
+    buf_T	*vb_buf;
+    char_u	vb_name[1];	/* actually longer */
+};
+
+static vimarkbuf_T dumvb;
+#define HI2VB(hi) ((vimarkbuf_T *)((hi)->hi_key - (dumvb.vb_key - (char_u *)&dumvb)))
+
+static int viminfo_bufs_init __ARGS((hashtab_T *ht, char_u *name_buf));
+static buf_T *viminfo_bufs_find __ARGS((hashtab_T *ht, char_u *name));
+static void viminfo_bufs_clear __ARGS((hashtab_T *ht));
+
+/*
+ * Fill hashtable "ht" with all buffers that have a name.  "name_buf" is used
+ * for the names, it must be LSIZE bytes.
+ * Returns FAIL when out of memory, "ht" is cleared then.
+ */
+    static int
+viminfo_bufs_init(ht, name_buf)
+    hashtab_T	*ht;
+    char_u	*name_buf;
+{
+    buf_T	*buf;
+    vimarkbuf_T	*vb;
+    vimarkbuf_T	*last;
+    hashitem_T	*hi;
+    hash_T	hash;
+
+    hash_init(ht);
+    for (buf = firstbuf; buf != NULL; buf = buf->b_next)
+	if (buf->b_ffname != NULL)
+	{
+	    home_replace(NULL, buf->b_ffname, name_buf, LSIZE, TRUE);
+	    vb = (vimarkbuf_T *)alloc((unsigned)(sizeof(vimarkbuf_T)
+							 + STRLEN(name_buf)));
+	    if (vb == NULL)
+		break;
+	    STRCPY(vb->vb_name, name_buf);
+	    buf_name_key(vb->vb_name, vb->vb_key);
+	    vb->vb_buf = buf;
+	    vb->vb_next = NULL;
+
+	    /* Append to the entries with the same key, so that the first
+	     * buffer in the list is found first. */
+	    hash = hash_hash(vb->vb_key);
+	    hi = hash_lookup(ht, vb->vb_key, hash);
+	    if (!HASHITEM_EMPTY(hi))
+	    {
+		for (last = HI2VB(hi); last->vb_next != NULL;
+							 last = last->vb_next)
+		    ;
+		last->vb_next = vb;
+	    }
+	    else if (hash_add_item(ht, hi, vb->vb_key, hash) == FAIL)
+	    {
+		vim_free(vb);
+		break;
+	    }
+	}
+    if (buf != NULL)
+    {
+	viminfo_bufs_clear(ht);
+	return FAIL;
+    }
+    return OK;
+}
+
+/*
+ * Find the first buffer in hashtable "ht" with home_replace()'d name "name".
+ */
+    static buf_T *
+viminfo_bufs_find(ht, name)
+    hashtab_T	*ht;
+    char_u	*name;
+{
+    char_u	key[BUFINDEX_KEYLEN];
+    hashitem_T	*hi;
+    vimarkbuf_T	*vb;
+
+    buf_name_key(name, key);
+    hi = hash_find(ht, key);
+    if (HASHITEM_EMPTY(hi))
+	return NULL;
+    for (vb = HI2VB(hi); vb != NULL; vb = vb->vb_next)
+	if (fnamecmp(name, vb->vb_name) == 0)
+	    return vb->vb_buf;
+    return NULL;
+}
+
+    static void
+viminfo_bufs_clear(ht)
+    hashtab_T	*ht;
+{
+    hashitem_T	*hi;
+    vimarkbuf_T	*vb;
+    vimarkbuf_T	*next;
+    int		todo;
+
+    todo = (int)ht->ht_used;
+    for (hi = ht->ht_array; todo > 0; ++hi)
+	if (!HASHITEM_EMPTY(hi))
+	{
+	    --todo;
+	    for (vb = HI2VB(hi); vb != NULL; vb = next)
+	    {
+		next = vb->vb_next;
+		vim_free(vb);
+	    }
+	}
+    hash_clear(ht);
+}
+
 /*
  * Handle marks in the viminfo file:
  * fp_out != NULL: copy marks for buffers not in buffer list
@@ -1665,6 +1786,8 @@ copy_viminfo_marks(virp, fp_out, count, eof, flags)
     char_u	*p;
     char_u	*name_buf;
     pos_T	pos;
+    hashtab_T	bufs_ht;
+    int		use_bufs_ht = FALSE;
 #ifdef FEAT_EVAL
     list_T	*list = NULL;
 #endif
@@ -1673,6 +1796,9 @@ copy_viminfo_marks(virp, fp_out, count, eof, flags)
 	return;
     *name_buf = NUL;
 
+    if (fp_out != NULL)
+	use_bufs_ht = (viminfo_bufs_init(&bufs_ht, name_buf) == OK);
+
 #ifdef FEAT_EVAL
     if (fp_out == NULL && (flags & (VIF_GET_OLDFILES | VIF_FORCEIT)))
     {
@@ -1734,14 +1860,18 @@ copy_viminfo_marks(virp, fp_out, count, eof, flags)
 	}
 	else /* fp_out != NULL */
 	{
-	    /* This is slow if there are many buffers!! */
-	    for (buf = firstbuf; buf != NULL; buf = buf->b_next)
-		if (buf->b_ffname != NULL)
-		{
-		    home_replace(NULL, buf->b_ffname, name_buf, LSIZE, TRUE);
-		    if (fnamecmp(str, name_buf) == 0)
-			break;
-		}
+	    if (use_bufs_ht)
+		buf = viminfo_bufs_find(&bufs_ht, str);
+	    else
+		/* This is slow if there are many buffers!! */
+		for (buf = firstbuf; buf != NULL; buf = buf->b_next)
+		    if (buf->b_ffname != NULL)
+		    {
+			home_replace(NULL, buf->b_ffname, name_buf, LSIZE,
+									TRUE);
+			if (fnamecmp(str, name_buf) == 0)
+			    break;
+		    }
 
 	    /*
 	     * copy marks if the buffer has not been loaded
@@ -1811,6 +1941,8 @@ copy_viminfo_marks(virp, fp_out, count, eof, flags)
 	    break;
 	}
     }
+    if (use_bufs_ht)
+	viminfo_bufs_clear(&bufs_ht);
     vim_free(name_buf);
 }
 #endif /* FEAT_VIMINFO */
@@ -140,7 +140,6 @@ static int utf_ptr2cells_len __ARGS((char_u *p, int size));
 static int dbcs_char2cells __ARGS((int c));
 static int dbcs_ptr2cells_len __ARGS((char_u *p, int size));
 static int dbcs_ptr2char __ARGS((char_u *p));
-static int utf_safe_read_char_adv __ARGS((char_u **s, size_t *n));
 
 /*
  * Lookup table to quickly get the length in bytes of a UTF-8 character from
@@ -1616,6 +1615,50 @@ dbcs_char2cells(c)
     return MB_BYTE2LEN((unsigned)c >> 8);
 }
 
+/*
+ * Return the number of bytes at the start of "p" that are ASCII and not a
+ * NUL.  Looks at no more than "len" bytes, stops at a NUL when "len" < 0.
+ * When the length is known whole words are checked at a time, this is much
+ * faster than decoding one character at a time for plain ASCII text.
+ */
+    int
+utf_ascii_len(p, len)
+    char_u	*p;
+    int		len;
+{
+    int		n = 0;
+
+    if (len >= (int)sizeof(long_u) * 2)
+    {
+	/* Go byte by byte until "p + n" is aligned. */
+	while (((long_u)(p + n) & (sizeof(long_u) - 1)) != 0)
+	{
+	    if (p[n] == NUL || p[n] >= 0x80)
+		return n;
+	    ++n;
+	}
+
+	/* Check a word at a time: stop when one of the bytes has the high
+	 * bit set or is zero.  Copy the bytes instead of casting the
+	 * pointer, that would break the aliasing rules. */
+	while (n + (int)sizeof(long_u) <= len)
+	{
+	    long_u	w;
+	    long_u	ones = (~(long_u)0) / 0xff;	/* 0x0101... */
+	    long_u	highs = ones << 7;		/* 0x8080... */
+
+	    mch_memmove(&w, p + n, sizeof(long_u));
+	    if ((w & highs) != 0 || ((w - ones) & ~w & highs) != 0)
+		break;
+	    n += (int)sizeof(long_u);
+	}
+    }
+
+    while ((len < 0 || n < len) && p[n] != NUL && p[n] < 0x80)
+	++n;
+    return n;
+}
+
 /*
  * Return the number of cells occupied by string "p".
  * Stop at a NUL character.  When "len" >= 0 stop at character "p[len]".
@@ -1626,10 +1669,24 @@ mb_string2cells(p, len)
     int	    len;
 {
     int i;
+    int n;
     int clen = 0;
 
-    for (i = 0; (len < 0 || i < len) && p[i] != NUL; i += (*mb_ptr2len)(p + i))
-	clen += (*mb_ptr2cells)(p + i);
+    for (i = 0; (len < 0 || i < len) && p[i] != NUL; )
+    {
+	if (enc_utf8 && p[i] < 0x80)
+	{
+	    /* A run of ASCII characters takes one cell per byte. */
+	    n = utf_ascii_len(p + i, len < 0 ? -1 : len - i);
+	    clen += n;
+	    i += n;
+	}
+	else
+	{
+	    clen += (*mb_ptr2cells)(p + i);
+	    i += (*mb_ptr2len)(p + i);
+	}
+    }
     return clen;
 }
 
@@ -1754,7 +1811,7 @@ utf_ptr2char(p)
  * If byte sequence is illegal or incomplete, returns -1 and does not advance
  * "s".
  */
-    static int
+    int
 utf_safe_read_char_adv(s, n)
     char_u      **s;
     size_t      *n;
@@ -3671,6 +3728,18 @@ utf_valid_string(s, end)
 
     while (end == NULL ? *p != NUL : p < end)
     {
+	if (*p < 0x80)
+	{
+	    /* Skip over ASCII quickly. */
+	    p += utf_ascii_len(p, end == NULL ? -1 : (int)(end - p));
+	    if (end == NULL ? *p == NUL : p >= end)
+		break;
+	    if (*p == NUL)
+	    {
+		++p;	/* a NUL before "end" is valid */
+		continue;
+	    }
+	}
 	l = utf8len_tab_zero[*p];
 	if (l == 0)
 	    return FALSE;	/* invalid lead byte */
@@ -209,6 +209,16 @@ struct block0
  */
 static linenr_T	lowest_marked = 0;
 
+#ifdef FEAT_BYTEOFF
+/*
+ * The chunk last used by ml_updatechunk(): "ml_upd_lastcurix" is the index of
+ * the chunk in buffer "ml_upd_lastbuf" that starts at "ml_upd_lastcurline".
+ */
+static buf_T	*ml_upd_lastbuf = NULL;
+static linenr_T	ml_upd_lastcurline;
+static int	ml_upd_lastcurix;
+#endif
+
 /*
  * arguments for ml_find_line()
  */
@@ -821,6 +831,8 @@ ml_close(buf, del_file)
 #ifdef FEAT_BYTEOFF
     vim_free(buf->b_ml.ml_chunksize);
     buf->b_ml.ml_chunksize = NULL;
+    if (ml_upd_lastbuf == buf)
+	ml_upd_lastbuf = NULL;
 #endif
     buf->b_ml.ml_mfp = NULL;
 
@@ -4943,11 +4955,6 @@ ml_updatechunk(buf, line, len, updtype)
     long	len;
     int		updtype;
 {
-    static buf_T	*ml_upd_lastbuf = NULL;
-    static linenr_T	ml_upd_lastline;
-    static linenr_T	ml_upd_lastcurline;
-    static int		ml_upd_lastcurix;
-
     linenr_T		curline = ml_upd_lastcurline;
     int			curix = ml_upd_lastcurix;
     long		size;
@@ -4971,6 +4978,7 @@ ml_updatechunk(buf, line, len, updtype)
 	buf->b_ml.ml_usedchunks = 1;
 	buf->b_ml.ml_chunksize[0].mlcs_numlines = 1;
 	buf->b_ml.ml_chunksize[0].mlcs_totalsize = 1;
+	ml_upd_lastbuf = NULL;
     }
 
     if (updtype == ML_CHNK_UPDLINE && buf->b_ml.ml_line_count == 1)
@@ -4982,28 +4990,25 @@ ml_updatechunk(buf, line, len, updtype)
 	buf->b_ml.ml_chunksize[0].mlcs_numlines = 1;
 	buf->b_ml.ml_chunksize[0].mlcs_totalsize =
 				  (long)STRLEN(buf->b_ml.ml_line_ptr) + 1;
+	ml_upd_lastbuf = NULL;
 	return;
     }
 
     /*
      * Find chunk that our line belongs to, curline will be at start of the
-     * chunk.
+     * chunk.  Start at the chunk found last time, unless our line is before
+     * it.  This avoids scanning all chunks from the start when many lines
+     * are changed from top to bottom, e.g. by ":g/pat/d".
      */
-    if (buf != ml_upd_lastbuf || line != ml_upd_lastline + 1
-	    || updtype != ML_CHNK_ADDLINE)
+    if (buf != ml_upd_lastbuf || line < ml_upd_lastcurline
+			       || ml_upd_lastcurix >= buf->b_ml.ml_usedchunks)
     {
-	for (curline = 1, curix = 0;
-	     curix < buf->b_ml.ml_usedchunks - 1
-	     && line >= curline + buf->b_ml.ml_chunksize[curix].mlcs_numlines;
-	     curix++)
-	{
-	    curline += buf->b_ml.ml_chunksize[curix].mlcs_numlines;
-	}
+	curline = 1;
+	curix = 0;
     }
-    else if (line >= curline + buf->b_ml.ml_chunksize[curix].mlcs_numlines
-		 && curix < buf->b_ml.ml_usedchunks - 1)
+    while (curix < buf->b_ml.ml_usedchunks - 1
+	    && line >= curline + buf->b_ml.ml_chunksize[curix].mlcs_numlines)
     {
-	/* Adjust cached curix & curline */
 	curline += buf->b_ml.ml_chunksize[curix].mlcs_numlines;
 	curix++;
     }
@@ -5147,6 +5152,10 @@ ml_updatechunk(buf, line, len, updtype)
 		    && (curchnk->mlcs_numlines + curchnk[-1].mlcs_numlines)
 		       > MLCS_MINL))
 	{
+	    /* No chunks moved, curix & curline are still valid */
+	    ml_upd_lastbuf = buf;
+	    ml_upd_lastcurline = curline;
+	    ml_upd_lastcurix = curix;
 	    return;
 	}
 
@@ -5164,7 +5173,6 @@ ml_updatechunk(buf, line, len, updtype)
 	return;
     }
     ml_upd_lastbuf = buf;
-    ml_upd_lastline = line;
     ml_upd_lastcurline = curline;
     ml_upd_lastcurix = curix;
 }
@@ -10011,6 +10011,7 @@ unix_expandpath(gap, path, wildoff, flags, didstar)
     int		len;
     int		starstar = FALSE;
     static int	stardepth = 0;	    /* depth for "**" expansion */
+    int		c;
 
     DIR		*dirp;
     struct dirent *dp;
@@ -10085,11 +10086,24 @@ unix_expandpath(gap, path, wildoff, flags, didstar)
 	if (p[0] == '*' && p[1] == '*')
 	    starstar = TRUE;
 
+    /* open the directory for scanning; when it doesn't exist nothing can
+     * match, don't bother compiling the pattern */
+    c = *s;
+    *s = NUL;
+    dirp = opendir(*buf == NUL ? "." : (char *)buf);
+    *s = c;
+    if (dirp == NULL)
+    {
+	vim_free(buf);
+	return 0;
+    }
+
     /* convert the file pattern to a regexp pattern */
     starts_with_dot = (*s == '.');
     pat = file_pat_to_reg_pat(s, e, NULL, FALSE);
     if (pat == NULL)
     {
+	closedir(dirp);
 	vim_free(buf);
 	return 0;
     }
@@ -10108,6 +10122,7 @@ unix_expandpath(gap, path, wildoff, flags, didstar)
 
     if (regmatch.regprog == NULL && (flags & EW_NOTWILD) == 0)
     {
+	closedir(dirp);
 	vim_free(buf);
 	return 0;
     }
@@ -10123,10 +10138,6 @@ unix_expandpath(gap, path, wildoff, flags, didstar)
 	--stardepth;
     }
 
-    /* open the directory for scanning */
-    *s = NUL;
-    dirp = opendir(*buf == NUL ? "." : (char *)buf);
-
     /* Find all matching entries */
     if (dirp != NULL)
     {
@@ -10652,6 +10663,7 @@ has_env_var(p)
 
 #ifdef SPECIAL_WILDCHAR
 static int has_special_wildchar __ARGS((char_u *p));
+static int expand_braces __ARGS((garray_T *gap, char_u *pat));
 
 /*
  * Return TRUE if "p" contains a special wildcard character.
@@ -10670,6 +10682,105 @@ has_special_wildchar(p)
     }
     return FALSE;
 }
+
+/*
+ * Expand "{a,b}" in "pat" the way the shell does and add the resulting
+ * patterns to "gap".  "a{b,c{d,e}}f" results in "abf", "acdf" and "acef".
+ * A "{}" without a comma is kept, so is "${name}".
+ * Returns FALSE when "pat" contains other special characters that the shell
+ * must handle, or nothing to expand was found.  Nothing is added then.
+ */
+    static int
+expand_braces(gap, pat)
+    garray_T	*gap;
+    char_u	*pat;
+{
+    char_u	*p;
+    char_u	*open = NULL;
+    char_u	*close = NULL;
+    char_u	*alt;
+    char_u	*s;
+    int		depth;
+    int		has_comma;
+    int		len;
+    int		start_len = gap->ga_len;
+
+    for (p = pat; *p != NUL; mb_ptr_adv(p))
+    {
+	if (*p == '\\' && p[1] != NUL)
+	    ++p;
+	else if (*p == '`' || *p == '\'')
+	    return FALSE;
+	else if (*p == '{' && open == NULL && (p == pat || p[-1] != '$'))
+	{
+	    /* Find the matching '}', there must be a ',' at this level. */
+	    depth = 0;
+	    has_comma = FALSE;
+	    for (s = p + 1; *s != NUL; mb_ptr_adv(s))
+	    {
+		if (*s == '\\' && s[1] != NUL)
+		    ++s;
+		else if (*s == '{')
+		    ++depth;
+		else if (*s == '}' && depth-- == 0)
+		    break;
+		else if (*s == ',' && depth == 0)
+		    has_comma = TRUE;
+	    }
+	    if (*s == '}' && has_comma)
+	    {
+		open = p;
+		close = s;
+	    }
+	}
+    }
+    if (open == NULL)
+	return FALSE;
+
+    /* Produce "pre" + alternative + "post" for each alternative and expand
+     * the result again for the remaining braces. */
+    alt = open + 1;
+    depth = 0;
+    for (p = alt; p <= close; mb_ptr_adv(p))
+    {
+	if (*p == '\\' && p[1] != NUL)
+	    ++p;
+	else if (*p == '{')
+	    ++depth;
+	else if (*p == '}' && p != close)
+	    --depth;
+	else if ((*p == ',' && depth == 0) || p == close)
+	{
+	    len = (int)(open - pat) + (int)(p - alt) + (int)STRLEN(close + 1);
+	    s = alloc(len + 1);
+	    if (s == NULL)
+		break;
+	    mch_memmove(s, pat, open - pat);
+	    mch_memmove(s + (open - pat), alt, p - alt);
+	    STRCPY(s + (open - pat) + (p - alt), close + 1);
+	    if (!expand_braces(gap, s))
+	    {
+		if (ga_grow(gap, 1) == FAIL)
+		{
+		    vim_free(s);
+		    break;
+		}
+		((char_u **)gap->ga_data)[gap->ga_len++] = s;
+	    }
+	    else
+		vim_free(s);
+	    alt = p + 1;
+	}
+    }
+    if (p <= close)
+    {
+	/* out of memory */
+	while (gap->ga_len > start_len)
+	    vim_free(((char_u **)gap->ga_data)[--gap->ga_len]);
+	return FALSE;
+    }
+    return TRUE;
+}
 #endif
 
 /*
@@ -10719,6 +10830,8 @@ gen_expand_wildcards(num_pat, pat, num_file, file, flags)
      * here, call machine specific function for all the expansion.  This
      * avoids starting the shell for each argument separately.
      * For `=expr` do use the internal function.
+     * "{a,b}" is expanded here into separate patterns, starting a shell for
+     * that is slow.
      */
     for (i = 0; i < num_pat; i++)
     {
@@ -10727,7 +10840,39 @@ gen_expand_wildcards(num_pat, pat, num_file, file, flags)
 		&& !(vim_backtick(pat[i]) && pat[i][1] == '=')
 # endif
 	   )
+	    break;
+    }
+    if (i < num_pat)
+    {
+	ga_init2(&ga, (int)sizeof(char_u *), 30);
+	for (i = 0; i < num_pat; i++)
+	{
+	    if (!has_special_wildchar(pat[i])
+# ifdef VIM_BACKTICK
+		    || (vim_backtick(pat[i]) && pat[i][1] == '=')
+# endif
+		    )
+	    {
+		p = vim_strsave(pat[i]);
+		if (p == NULL || ga_grow(&ga, 1) == FAIL)
+		{
+		    vim_free(p);
+		    break;
+		}
+		((char_u **)ga.ga_data)[ga.ga_len++] = p;
+	    }
+	    else if (!expand_braces(&ga, pat[i]))
+		break;
+	}
+	if (i < num_pat)
+	{
+	    ga_clear_strings(&ga);
 	    return mch_expand_wildcards(num_pat, pat, num_file, file, flags);
+	}
+	i = gen_expand_wildcards(ga.ga_len, (char_u **)ga.ga_data,
+						     num_file, file, flags);
+	ga_clear_strings(&ga);
+	return i;
     }
 #endif
 
@@ -10975,6 +11120,36 @@ addfile(gap, f, flags)
 # define SEEK_END 2
 #endif
 
+#if defined(UNIX) && !defined(USE_SYSTEM)
+static int cmd_output_use_pipe __ARGS((char_u *cmd));
+
+/* Whether "/dev/fd/1" can be used to read command output through a pipe,
+ * MAYBE when not checked yet. */
+static int cmd_output_pipe = MAYBE;
+
+/*
+ * Return TRUE when the output of "cmd" can be read through a pipe.
+ * Not for a command ending in "&": a job started in the background keeps the
+ * pipe open.
+ */
+    static int
+cmd_output_use_pipe(cmd)
+    char_u	*cmd;
+{
+    char_u	*p;
+
+    if (cmd_output_pipe == MAYBE)
+	cmd_output_pipe = mch_isdir((char_u *)"/dev/fd");
+    if (!cmd_output_pipe)
+	return FALSE;
+
+    p = cmd + STRLEN(cmd);
+    while (p > cmd && vim_iswhite(p[-1]))
+	--p;
+    return p == cmd || p[-1] != '&';
+}
+#endif
+
 /*
  * Get the stdout of an external command.
  * If "ret_len" is NULL replace NUL characters with NL.  When "ret_len" is not
@@ -10988,7 +11163,7 @@ get_cmd_output(cmd, infile, flags, ret_len)
     int		flags;		/* can be SHELL_SILENT */
     int		*ret_len;
 {
-    char_u	*tempname;
+    char_u	*tempname = NULL;
     char_u	*command;
     char_u	*buffer = NULL;
     int		len;
@@ -10998,6 +11173,36 @@ get_cmd_output(cmd, infile, flags, ret_len)
     if (check_restricted() || check_secure())
 	return NULL;
 
+# if defined(UNIX) && !defined(USE_SYSTEM)
+    if (cmd_output_use_pipe(cmd))
+    {
+	garray_T    ga;
+
+	/*
+	 * Read the output through a pipe, no need to create, read and delete
+	 * a temp file.  "/dev/fd/1" is the pipe in the child, thus
+	 * 'shellredir' is applied just like for a temp file.
+	 */
+	command = make_filter_cmd(cmd, infile, (char_u *)"/dev/fd/1");
+	if (command == NULL)
+	    return NULL;
+	ga_init2(&ga, 1, 4096);
+	++no_check_timestamps;
+	mch_call_shell_output(command, SHELL_DOOUT | SHELL_EXPAND | flags, &ga);
+	--no_check_timestamps;
+	vim_free(command);
+
+	if (ga_grow(&ga, 1) == FAIL)	/* room for the NUL */
+	{
+	    ga_clear(&ga);
+	    return NULL;
+	}
+	buffer = (char_u *)ga.ga_data;
+	len = i = ga.ga_len;
+	goto got_output;
+    }
+# endif
+
     /* get a name for the temp file */
     if ((tempname = vim_tempname('o')) == NULL)
     {
@@ -11050,6 +11255,9 @@ get_cmd_output(cmd, infile, flags, ret_len)
 #ifdef VMS
     len = i;	/* VMS doesn't give us what we asked for... */
 #endif
+# if defined(UNIX) && !defined(USE_SYSTEM)
+got_output:
+# endif
     if (i != len)
     {
 	EMSG2(_(e_notread), tempname);
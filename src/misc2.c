@@ -1076,6 +1076,7 @@ free_all_mem()
     do_cmdline_cmd((char_u *)"mapclear");
     do_cmdline_cmd((char_u *)"mapclear!");
     do_cmdline_cmd((char_u *)"abclear");
+    free_map_lhs();
 # if defined(FEAT_EVAL)
     do_cmdline_cmd((char_u *)"breakdel *");
 # endif
@@ -4214,6 +4215,8 @@ typedef struct ff_stack
 typedef struct ff_visited
 {
     struct ff_visited	*ffv_next;
+    struct ff_visited	*ffv_hnext;	/* next entry with the same ffv_key */
+    char_u		ffv_key[BUFINDEX_KEYLEN]; /* key in ffvl_hashtab */
 
 #ifdef FEAT_PATH_EXTRA
     /* Visited directories are different if the wildcard string are
@@ -4235,6 +4238,10 @@ typedef struct ff_visited
     char_u		ffv_fname[1];	/* actually longer */
 } ff_visited_T;
 
+/* HI2FFV() converts a hashitem pointer to an ff_visited_T pointer. */
+static ff_visited_T dumffv;
+#define HI2FFV(hi) ((ff_visited_T *)((hi)->hi_key - (dumffv.ffv_key - (char_u *)&dumffv)))
+
 /*
  * We might have to manage several visited lists during a search.
  * This is especially needed for the tags option. If tags is set to:
@@ -4258,6 +4265,10 @@ typedef struct ff_visited_list_hdr
 
     ff_visited_T		*ffvl_visited_list;
 
+    /* Entries of ffvl_visited_list by device/inode or by name, to avoid
+     * going over the whole list for every directory. */
+    hashtab_T			ffvl_hashtab;
+
 } ff_visited_list_hdr_T;
 
 
@@ -4305,9 +4316,9 @@ typedef struct ff_search_ctx_T
 
 /* locally needed functions */
 #ifdef FEAT_PATH_EXTRA
-static int ff_check_visited __ARGS((ff_visited_T **, char_u *, char_u *));
+static int ff_check_visited __ARGS((ff_visited_list_hdr_T *, char_u *, char_u *));
 #else
-static int ff_check_visited __ARGS((ff_visited_T **, char_u *));
+static int ff_check_visited __ARGS((ff_visited_list_hdr_T *, char_u *));
 #endif
 static void vim_findfile_free_visited_list __ARGS((ff_visited_list_hdr_T **list_headp));
 static void ff_free_visited_list __ARGS((ff_visited_T *vl));
@@ -4903,8 +4914,7 @@ vim_findfile(search_ctx_arg)
 	     * first time (hence stackp->ff_filearray == NULL)
 	     */
 	    if (stackp->ffs_filearray == NULL
-		    && ff_check_visited(&search_ctx->ffsc_dir_visited_list
-							  ->ffvl_visited_list,
+		    && ff_check_visited(search_ctx->ffsc_dir_visited_list,
 			stackp->ffs_fix_path
 #ifdef FEAT_PATH_EXTRA
 			, stackp->ffs_wc_path
@@ -5105,7 +5115,7 @@ vim_findfile(search_ctx_arg)
 						   == mch_isdir(file_path)))))
 #ifndef FF_VERBOSE
 				    && (ff_check_visited(
-					    &search_ctx->ffsc_visited_list->ffvl_visited_list,
+					    search_ctx->ffsc_visited_list,
 					    file_path
 #ifdef FEAT_PATH_EXTRA
 					    , (char_u *)""
@@ -5116,7 +5126,7 @@ vim_findfile(search_ctx_arg)
 			    {
 #ifdef FF_VERBOSE
 				if (ff_check_visited(
-					    &search_ctx->ffsc_visited_list->ffvl_visited_list,
+					    search_ctx->ffsc_visited_list,
 					    file_path
 #ifdef FEAT_PATH_EXTRA
 					    , (char_u *)""
@@ -5301,6 +5311,7 @@ vim_findfile_free_visited_list(list_headp)
     {
 	vp = (*list_headp)->ffvl_next;
 	ff_free_visited_list((*list_headp)->ffvl_visited_list);
+	hash_clear(&(*list_headp)->ffvl_hashtab);
 
 	vim_free((*list_headp)->ffvl_filename);
 	vim_free(*list_headp);
@@ -5382,6 +5393,7 @@ ff_get_visited_list(filename, list_headp)
 	return NULL;
 
     retptr->ffvl_visited_list = NULL;
+    hash_init(&retptr->ffvl_hashtab);
     retptr->ffvl_filename = vim_strsave(filename);
     if (retptr->ffvl_filename == NULL)
     {
@@ -5447,18 +5459,22 @@ ff_wc_equal(s1, s2)
  *	    never.
  */
     static int
-ff_check_visited(visited_list, fname
+ff_check_visited(vlist, fname
 #ifdef FEAT_PATH_EXTRA
 	, wc_path
 #endif
 	)
-    ff_visited_T	**visited_list;
+    ff_visited_list_hdr_T *vlist;
     char_u		*fname;
 #ifdef FEAT_PATH_EXTRA
     char_u		*wc_path;
 #endif
 {
     ff_visited_T	*vp;
+    ff_visited_T	*first = NULL;
+    char_u		key[BUFINDEX_KEYLEN];
+    hash_T		hash;
+    hashitem_T		*hi;
 #ifdef UNIX
     struct stat		st;
     int			url = FALSE;
@@ -5484,8 +5500,19 @@ ff_check_visited(visited_list, fname
 	    return FAIL;
     }
 
-    /* check against list of already visited files */
-    for (vp = *visited_list; vp != NULL; vp = vp->ffv_next)
+#ifdef UNIX
+    if (!url)
+	sprintf((char *)key, "%lx:%lx", (long_u)st.st_dev, (long_u)st.st_ino);
+    else
+#endif
+	buf_name_key(ff_expand_buffer, key);
+
+    /* check against the already visited files with the same key */
+    hash = hash_hash(key);
+    hi = hash_lookup(&vlist->ffvl_hashtab, key, hash);
+    if (!HASHITEM_EMPTY(hi))
+	first = HI2FFV(hi);
+    for (vp = first; vp != NULL; vp = vp->ffv_hnext)
     {
 	if (
 #ifdef UNIX
@@ -5535,9 +5562,23 @@ ff_check_visited(visited_list, fname
 	else
 	    vp->ffv_wc_path = NULL;
 #endif
+	STRCPY(vp->ffv_key, key);
+	if (first != NULL)
+	{
+	    /* add after the first entry, the hashtable points to that one */
+	    vp->ffv_hnext = first->ffv_hnext;
+	    first->ffv_hnext = vp;
+	}
+	else
+	{
+	    /* When out of memory the entry won't be found, a directory may
+	     * then be searched twice. */
+	    vp->ffv_hnext = NULL;
+	    (void)hash_add_item(&vlist->ffvl_hashtab, hi, vp->ffv_key, hash);
+	}
 
-	vp->ffv_next = *visited_list;
-	*visited_list = vp;
+	vp->ffv_next = vlist->ffvl_visited_list;
+	vlist->ffvl_visited_list = vp;
     }
 
     return OK;
@@ -6538,25 +6579,18 @@ read_string(fd, cnt)
     int		cnt;
 {
     char_u	*str;
-    int		i;
-    int		c;
 
     /* allocate memory */
     str = alloc((unsigned)cnt + 1);
     if (str != NULL)
     {
 	/* Read the string.  Quit when running into the EOF. */
-	for (i = 0; i < cnt; ++i)
+	if (cnt > 0 && fread(str, (size_t)cnt, (size_t)1, fd) != 1)
 	{
-	    c = getc(fd);
-	    if (c == EOF)
-	    {
-		vim_free(str);
-		return NULL;
-	    }
-	    str[i] = c;
+	    vim_free(str);
+	    return NULL;
 	}
-	str[i] = NUL;
+	str[cnt] = NUL;
     }
     return str;
 }
@@ -7887,6 +7887,13 @@ set_bool_option(opt_idx, varp, value, opt_flags)
 	redraw_all_later(SOME_VALID);
     }
 
+    /* when 'fileignorecase' is changed the buffer name index must be
+     * updated */
+    else if ((int *)varp == (int *)&p_fic)
+    {
+	buf_reindex_all();
+    }
+
 #ifdef FEAT_SEARCH_EXTRA
     /* when 'hlsearch' is set or reset: reset no_hlsearch */
     else if ((int *)varp == &p_hls)
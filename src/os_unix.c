@@ -229,6 +229,9 @@ static volatile int do_resize = FALSE;
 static char_u	*extra_shell_arg = NULL;
 static int	show_shell_mess = TRUE;
 #endif
+#ifndef USE_SYSTEM
+static garray_T	*shell_output_ga = NULL;    /* see mch_call_shell_output() */
+#endif
 /* volatile because it is used in signal handler deathtrap(). */
 static volatile int deadly_signal = 0;	    /* The signal we caught */
 /* volatile because it is used in signal handler deathtrap(). */
@@ -3982,6 +3985,7 @@ wait4pid(child, status)
     waitstatus	*status;
 {
     pid_t wait_pid = 0;
+    long  delay_msec = 1;
 
     while (wait_pid != child)
     {
@@ -3996,8 +4000,11 @@ wait4pid(child, status)
 # endif
 	if (wait_pid == 0)
 	{
-	    /* Wait for 10 msec before trying again. */
-	    mch_delay(10L, TRUE);
+	    /* Wait a bit before trying again.  Start with a short delay, most
+	     * commands finish quickly, then back off to 10 msec. */
+	    mch_delay(delay_msec, TRUE);
+	    if (delay_msec < 10L)
+		delay_msec = delay_msec * 2 > 10L ? 10L : delay_msec * 2;
 	    continue;
 	}
 	if (wait_pid <= 0
@@ -4323,6 +4330,18 @@ mch_call_shell(cmd, options)
 	    }
 	}
     }
+    else if ((options & SHELL_OUTPUT) && shell_output_ga != NULL)
+    {
+	/* Only need a pipe to read the output of the command. */
+	pipe_error = (pipe(fd_fromshell) < 0);
+	if (pipe_error)
+	{
+	    MSG_PUTS(_("\nCannot create pipes\n"));
+	    out_flush();
+	}
+    }
+    else
+	options &= ~SHELL_OUTPUT;
 
     if (!pipe_error)			/* pty or pipe opened or not used */
     {
@@ -4354,6 +4373,11 @@ mch_call_shell(cmd, options)
 		    close(fd_fromshell[1]);
 		}
 	    }
+	    else if (options & SHELL_OUTPUT)
+	    {
+		close(fd_fromshell[0]);
+		close(fd_fromshell[1]);
+	    }
 	}
 	else if (pid == 0)	/* child */
 	{
@@ -4394,6 +4418,17 @@ mch_call_shell(cmd, options)
 		    /* Don't need this now that we've duplicated it */
 		    close(fd);
 		}
+
+		if (options & SHELL_OUTPUT)
+		{
+		    /* Send stdout to the pipe.  'shellredir' in the command
+		     * redirects to "/dev/fd/1", thus also stderr when it
+		     * contains "2>&1" or ">&". */
+		    close(fd_fromshell[0]);
+		    close(1);
+		    ignored = dup(fd_fromshell[1]);
+		    close(fd_fromshell[1]);
+		}
 	    }
 	    else if ((options & (SHELL_READ|SHELL_WRITE))
 # ifdef FEAT_GUI
@@ -4523,6 +4558,56 @@ mch_call_shell(cmd, options)
 	    catch_signals(SIG_IGN, SIG_ERR);
 	    catch_int_signal();
 
+	    if (options & SHELL_OUTPUT)
+	    {
+		garray_T    *gap = shell_output_ga;
+		int	    len;
+
+		/*
+		 * Read the output of the command until it closes the pipe or
+		 * the shell has exited and nothing more is available.  A job
+		 * the command started in the background may keep the pipe
+		 * open, don't wait for it.
+		 * Grow the buffer by doubling, output can be big.
+		 */
+		close(fd_fromshell[1]);
+		for (;;)
+		{
+		    if (!RealWaitForChar(fd_fromshell[0],
+					   wait_pid == pid ? 0L : 10L, NULL))
+		    {
+			if (wait_pid == pid)
+			    break;
+# ifdef __NeXT__
+			wait_pid = wait4(pid, &status, WNOHANG,
+							  (struct rusage *)0);
+# else
+			wait_pid = waitpid(pid, &status, WNOHANG);
+# endif
+			/* When the shell has exited read what is still
+			 * available, then break the loop above. */
+			if ((wait_pid == (pid_t)-1 && errno == ECHILD)
+				|| (wait_pid == pid && WIFEXITED(status)))
+			    wait_pid = pid;
+			else
+			    wait_pid = 0;
+			continue;
+		    }
+		    if (ga_grow(gap, gap->ga_len < 4096 ? 4096 : gap->ga_len)
+								      == FAIL)
+			break;
+		    len = read(fd_fromshell[0],
+				       (char *)gap->ga_data + gap->ga_len,
+				       (size_t)(gap->ga_maxlen - gap->ga_len));
+		    if (len < 0 && errno == EINTR)
+			continue;
+		    if (len <= 0)
+			break;
+		    gap->ga_len += len;
+		}
+		close(fd_fromshell[0]);
+	    }
+
 	    /*
 	     * For the GUI we redirect stdin, stdout and stderr to our window.
 	     * This is also used to pipe stdin/stdout to/from the external
@@ -5112,6 +5197,29 @@ error:
 #endif /* USE_SYSTEM */
 }
 
+#if !defined(USE_SYSTEM) || defined(PROTO)
+/*
+ * Execute "cmd" with call_shell() and read what it writes to stdout through
+ * a pipe into "gap", instead of redirecting it to a temp file.
+ * Returns what call_shell() returns.
+ */
+    int
+mch_call_shell_output(cmd, options, gap)
+    char_u	*cmd;
+    int		options;	/* SHELL_*, see vim.h */
+    garray_T	*gap;		/* initialized with an item size of one */
+{
+    int		retval;
+
+    shell_output_ga = gap;
+    show_shell_mess = FALSE;	/* don't use a pty for the GUI */
+    retval = call_shell(cmd, options | SHELL_OUTPUT);
+    show_shell_mess = TRUE;
+    shell_output_ga = NULL;
+    return retval;
+}
+#endif
+
 /*
  * Check for CTRL-C typed by reading all available characters.
  * In cooked mode we should get SIGINT, no need to check.
@@ -11,6 +11,9 @@ int do_buffer __ARGS((int action, int start, int dir, int count, int forceit));
 void set_curbuf __ARGS((buf_T *buf, int action));
 void enter_buffer __ARGS((buf_T *buf));
 void do_autochdir __ARGS((void));
+void buf_reindex __ARGS((buf_T *buf));
+void buf_reindex_all __ARGS((void));
+void buf_name_key __ARGS((char_u *ffname, char_u *key));
 buf_T *buflist_new __ARGS((char_u *ffname, char_u *sfname, linenr_T lnum, int flags));
 void free_buf_options __ARGS((buf_T *buf, int free_p_ff));
 int buflist_getfile __ARGS((int n, linenr_T lnum, int options, int forceit));
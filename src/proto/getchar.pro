@@ -50,6 +50,7 @@ int inchar __ARGS((char_u *buf, int maxlen, long wait_time, int tb_change_cnt));
 int fix_input_buffer __ARGS((char_u *buf, int len, int script));
 int input_available __ARGS((void));
 int do_map __ARGS((int maptype, char_u *arg, int mode, int abbrev));
+void free_map_lhs __ARGS((void));
 int get_map_mode __ARGS((char_u **cmdp, int forceit));
 void map_clear __ARGS((char_u *cmdp, char_u *arg, int forceit, int abbr));
 void map_clear_int __ARGS((buf_T *buf, int mode, int local, int abbr));
@@ -16,12 +16,14 @@ int utf_ptr2cells __ARGS((char_u *p));
 int dbcs_ptr2cells __ARGS((char_u *p));
 int latin_ptr2cells_len __ARGS((char_u *p, int size));
 int latin_char2cells __ARGS((int c));
+int utf_ascii_len __ARGS((char_u *p, int len));
 int mb_string2cells __ARGS((char_u *p, int len));
 int latin_off2cells __ARGS((unsigned off, unsigned max_off));
 int dbcs_off2cells __ARGS((unsigned off, unsigned max_off));
 int utf_off2cells __ARGS((unsigned off, unsigned max_off));
 int latin_ptr2char __ARGS((char_u *p));
 int utf_ptr2char __ARGS((char_u *p));
+int utf_safe_read_char_adv __ARGS((char_u **s, size_t *n));
 int mb_ptr2char_adv __ARGS((char_u **pp));
 int mb_cptr2char_adv __ARGS((char_u **pp));
 int arabic_combine __ARGS((int one, int two));
@@ -56,6 +56,7 @@ int mch_get_shellsize __ARGS((void));
 void mch_set_shellsize __ARGS((void));
 void mch_new_shellsize __ARGS((void));
 int mch_call_shell __ARGS((char_u *cmd, int options));
+int mch_call_shell_output __ARGS((char_u *cmd, int options, garray_T *gap));
 void mch_breakcheck __ARGS((void));
 int mch_expandpath __ARGS((garray_T *gap, char_u *path, int flags));
 int mch_expand_wildcards __ARGS((int num_pat, char_u **pat, int *num_file, char_u ***file, int flags));
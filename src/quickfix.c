@@ -104,8 +104,38 @@ struct efm_S
 				/*   '-' do not include this line */
 				/*   '+' include whole line in message */
     int		    conthere;	/* %> used */
+    char_u	    *must;	/* text that a matching line must contain or
+				   NULL */
 };
 
+/* Conversion of the % items in 'errorformat' to a regexp pattern. */
+static struct fmtpattern
+{
+    char_u	convchar;
+    char	*pattern;
+} fmt_pat[FMT_PATTERNS] =
+{
+    {'f', ".\\+"},	    /* only used when at end */
+    {'n', "\\d\\+"},
+    {'l', "\\d\\+"},
+    {'c', "\\d\\+"},
+    {'t', "."},
+    {'m', ".\\+"},
+    {'r', ".*"},
+    {'p', "[- 	.]*"},
+    {'v', "\\d\\+"},
+    {'s', ".\\+"}
+};
+
+/* The compiled 'errorformat' used last and the option value it was compiled
+ * from, with the 'regexpengine' value used for compiling. */
+static efm_T	*qf_efm_cache = NULL;
+static char_u	*qf_efm_cache_str = NULL;
+static long	qf_efm_cache_re = 0;
+
+static efm_T	*parse_efm_option __ARGS((char_u *efm, char_u *errmsg));
+static void	efm_keep_must __ARGS((efm_T *fmt_ptr, char_u *lit, int *lit_len));
+static void	free_efm_list __ARGS((efm_T **fmt_first));
 static int	qf_init_ext __ARGS((qf_info_T *qi, char_u *efile, buf_T *buf, typval_T *tv, char_u *errorformat, int newlist, linenr_T lnumfirst, linenr_T lnumlast, char_u *qf_title));
 static void	qf_store_title __ARGS((qf_info_T *qi, char_u *title));
 static void	qf_new_list __ARGS((qf_info_T *qi, char_u *qf_title));
@@ -116,6 +146,7 @@ static void	qf_msg __ARGS((qf_info_T *qi));
 static void	qf_free __ARGS((qf_info_T *qi, int idx));
 static char_u	*qf_types __ARGS((int, int));
 static int	qf_get_fnum __ARGS((char_u *, char_u *));
+static void	qf_buf_has_entry __ARGS((qf_info_T *qi, int fnum));
 static char_u	*qf_push_dir __ARGS((char_u *, struct dir_stack_T **));
 static char_u	*qf_pop_dir __ARGS((struct dir_stack_T **));
 static char_u	*qf_guess_filepath __ARGS((char_u *));
@@ -178,111 +209,30 @@ qf_init(wp, efile, errorformat, newlist, qf_title)
 }
 
 /*
- * Read the errorfile "efile" into memory, line by line, building the error
- * list.
- * Alternative: when "efile" is null read errors from buffer "buf".
- * Always use 'errorformat' from "buf" if there is a local value.
- * Then "lnumfirst" and "lnumlast" specify the range of lines to use.
- * Set the title of the list to "qf_title".
- * Return -1 for error, number of errors for success.
+ * Converts each part of 'errorformat' "efm" into a regexp program.  Only a few
+ * % characters are allowed.  "errmsg" is used for error messages.
+ * Returns a list of efm_T, NULL when there is an error.
  */
-    static int
-qf_init_ext(qi, efile, buf, tv, errorformat, newlist, lnumfirst, lnumlast,
-								     qf_title)
-    qf_info_T	    *qi;
-    char_u	    *efile;
-    buf_T	    *buf;
-    typval_T	    *tv;
-    char_u	    *errorformat;
-    int		    newlist;		/* TRUE: start a new error list */
-    linenr_T	    lnumfirst;		/* first line number to use */
-    linenr_T	    lnumlast;		/* last line number to use */
-    char_u	    *qf_title;
+    static efm_T *
+parse_efm_option(efm, errmsg)
+    char_u	*efm;
+    char_u	*errmsg;
 {
-    char_u	    *namebuf;
-    char_u	    *errmsg;
-    char_u	    *pattern;
-    char_u	    *fmtstr = NULL;
-    int		    col = 0;
-    char_u	    use_viscol = FALSE;
-    int		    type = 0;
-    int		    valid;
-    linenr_T	    buflnum = lnumfirst;
-    long	    lnum = 0L;
-    int		    enr = 0;
-    FILE	    *fd = NULL;
-    qfline_T	    *qfprev = NULL;	/* init to make SASC shut up */
-    char_u	    *efmp;
-    efm_T	    *fmt_first = NULL;
-    efm_T	    *fmt_last = NULL;
-    efm_T	    *fmt_ptr;
-    efm_T	    *fmt_start = NULL;
-    char_u	    *efm;
-    char_u	    *ptr;
-    char_u	    *srcptr;
-    int		    len;
-    int		    i;
-    int		    round;
-    int		    idx = 0;
-    int		    multiline = FALSE;
-    int		    multiignore = FALSE;
-    int		    multiscan = FALSE;
-    int		    retval = -1;	/* default: return error flag */
-    char_u	    *directory = NULL;
-    char_u	    *currfile = NULL;
-    char_u	    *tail = NULL;
-    char_u	    *p_str = NULL;
-    listitem_T	    *p_li = NULL;
-    struct dir_stack_T  *file_stack = NULL;
-    regmatch_T	    regmatch;
-    static struct fmtpattern
-    {
-	char_u	convchar;
-	char	*pattern;
-    }		    fmt_pat[FMT_PATTERNS] =
-		    {
-			{'f', ".\\+"},	    /* only used when at end */
-			{'n', "\\d\\+"},
-			{'l', "\\d\\+"},
-			{'c', "\\d\\+"},
-			{'t', "."},
-			{'m', ".\\+"},
-			{'r', ".*"},
-			{'p', "[- 	.]*"},
-			{'v', "\\d\\+"},
-			{'s', ".\\+"}
-		    };
-
-    namebuf = alloc(CMDBUFFSIZE + 1);
-    errmsg = alloc(CMDBUFFSIZE + 1);
-    pattern = alloc(CMDBUFFSIZE + 1);
-    if (namebuf == NULL || errmsg == NULL || pattern == NULL)
-	goto qf_init_end;
-
-    if (efile != NULL && (fd = mch_fopen((char *)efile, "r")) == NULL)
-    {
-	EMSG2(_(e_openerrf), efile);
-	goto qf_init_end;
-    }
-
-    if (newlist || qi->qf_curlist == qi->qf_listcount)
-	/* make place for a new list */
-	qf_new_list(qi, qf_title);
-    else if (qi->qf_lists[qi->qf_curlist].qf_count > 0)
-	/* Adding to existing list, find last entry. */
-	for (qfprev = qi->qf_lists[qi->qf_curlist].qf_start;
-			  qfprev->qf_next != qfprev; qfprev = qfprev->qf_next)
-	    ;
+    char_u	*fmtstr;
+    efm_T	*fmt_first = NULL;
+    efm_T	*fmt_last = NULL;
+    efm_T	*fmt_ptr;
+    char_u	*efmp;
+    char_u	*ptr;
+    char_u	*srcptr;
+    int		len;
+    int		i;
+    int		round;
+    int		idx = 0;
+    char_u	*lit;
+    int		lit_len = 0;
+    int		lit_ok;
 
-/*
- * Each part of the format string is copied and modified from errorformat to
- * regex prog.  Only a few % characters are allowed.
- */
-    /* Use the local value of 'errorformat' if it's set. */
-    if (errorformat == p_efm && tv == NULL && *buf->b_p_efm != NUL)
-	efm = buf->b_p_efm;
-    else
-	efm = errorformat;
     /*
      * Get some space to modify the format string into.
      */
@@ -295,7 +245,12 @@ qf_init_ext(qi, efile, buf, tv, errorformat, newlist, lnumfirst, lnumlast,
     i += 2; /* "%f" can become two chars longer */
 #endif
     if ((fmtstr = alloc(i)) == NULL)
-	goto error2;
+	return NULL;
+    if ((lit = alloc((unsigned)STRLEN(efm) + 1)) == NULL)
+    {
+	vim_free(fmtstr);
+	return NULL;
+    }
 
     while (efm[0] != NUL)
     {
@@ -304,7 +259,7 @@ qf_init_ext(qi, efile, buf, tv, errorformat, newlist, lnumfirst, lnumlast,
 	 */
 	fmt_ptr = (efm_T *)alloc_clear((unsigned)sizeof(efm_T));
 	if (fmt_ptr == NULL)
-	    goto error2;
+	    goto parse_efm_error;
 	if (fmt_first == NULL)	    /* first one */
 	    fmt_first = fmt_ptr;
 	else
@@ -324,10 +279,12 @@ qf_init_ext(qi, efile, buf, tv, errorformat, newlist, lnumfirst, lnumlast,
 	ptr = fmtstr;
 	*ptr++ = '^';
 	round = 0;
+	lit_ok = TRUE;
 	for (efmp = efm; efmp < efm + len; ++efmp)
 	{
 	    if (*efmp == '%')
 	    {
+		efm_keep_must(fmt_ptr, lit, &lit_len);
 		++efmp;
 		for (idx = 0; idx < FMT_PATTERNS; ++idx)
 		    if (fmt_pat[idx].convchar == *efmp)
@@ -339,7 +296,7 @@ qf_init_ext(qi, efile, buf, tv, errorformat, newlist, lnumfirst, lnumlast,
 			sprintf((char *)errmsg,
 				_("E372: Too many %%%c in format string"), *efmp);
 			EMSG(errmsg);
-			goto error2;
+			goto parse_efm_error;
 		    }
 		    if ((idx
 				&& idx < 6
@@ -352,7 +309,7 @@ qf_init_ext(qi, efile, buf, tv, errorformat, newlist, lnumfirst, lnumlast,
 			sprintf((char *)errmsg,
 				_("E373: Unexpected %%%c in format string"), *efmp);
 			EMSG(errmsg);
-			goto error2;
+			goto parse_efm_error;
 		    }
 		    fmt_ptr->addr[idx] = (char_u)++round;
 		    *ptr++ = '\\';
@@ -413,7 +370,7 @@ qf_init_ext(qi, efile, buf, tv, errorformat, newlist, lnumfirst, lnumlast,
 				if (efmp == efm + len)
 				{
 				    EMSG(_("E374: Missing ] in format string"));
-				    goto error2;
+				    goto parse_efm_error;
 				}
 			    }
 			}
@@ -428,13 +385,19 @@ qf_init_ext(qi, efile, buf, tv, errorformat, newlist, lnumfirst, lnumlast,
 			sprintf((char *)errmsg,
 				_("E375: Unsupported %%%c in format string"), *efmp);
 			EMSG(errmsg);
-			goto error2;
+			goto parse_efm_error;
 		    }
 		}
 		else if (vim_strchr((char_u *)"%\\.^$~[", *efmp) != NULL)
+		{
 		    *ptr++ = *efmp;		/* regexp magic characters */
+		    lit_ok = FALSE;
+		}
 		else if (*efmp == '#')
+		{
 		    *ptr++ = '*';
+		    lit_ok = FALSE;
+		}
 		else if (*efmp == '>')
 		    fmt_ptr->conthere = TRUE;
 		else if (efmp == efm + 1)		/* analyse prefix */
@@ -448,7 +411,7 @@ qf_init_ext(qi, efile, buf, tv, errorformat, newlist, lnumfirst, lnumlast,
 			sprintf((char *)errmsg,
 				_("E376: Invalid %%%c in format string prefix"), *efmp);
 			EMSG(errmsg);
-			goto error2;
+			goto parse_efm_error;
 		    }
 		}
 		else
@@ -456,32 +419,208 @@ qf_init_ext(qi, efile, buf, tv, errorformat, newlist, lnumfirst, lnumlast,
 		    sprintf((char *)errmsg,
 			    _("E377: Invalid %%%c in format string"), *efmp);
 		    EMSG(errmsg);
-		    goto error2;
+		    goto parse_efm_error;
 		}
 	    }
 	    else			/* copy normal character */
 	    {
 		if (*efmp == '\\' && efmp + 1 < efm + len)
+		{
 		    ++efmp;
+		    /* The character is copied as-is and may be magic. */
+		    if (*efmp != ',' && *efmp != ' ')
+			lit_ok = FALSE;
+		}
 		else if (vim_strchr((char_u *)".*^$~[", *efmp) != NULL)
 		    *ptr++ = '\\';	/* escape regexp atoms */
 		if (*efmp)
 		    *ptr++ = *efmp;
+
+		/* Collect the literal text.  Only ASCII non-letters, so that
+		 * ignoring case doesn't matter. */
+		if (*efmp == '\\')
+		    lit_ok = FALSE;
+		else if (*efmp != NUL && *efmp < 0x80 && !ASCII_ISALPHA(*efmp))
+		    lit[lit_len++] = *efmp;
+		else
+		    efm_keep_must(fmt_ptr, lit, &lit_len);
 	    }
 	}
+	efm_keep_must(fmt_ptr, lit, &lit_len);
+	if (!lit_ok)
+	{
+	    /* Can't be sure the text is matched literally, don't use it. */
+	    vim_free(fmt_ptr->must);
+	    fmt_ptr->must = NULL;
+	}
 	*ptr++ = '$';
 	*ptr = NUL;
 	if ((fmt_ptr->prog = vim_regcomp(fmtstr, RE_MAGIC + RE_STRING)) == NULL)
-	    goto error2;
+	    goto parse_efm_error;
 	/*
 	 * Advance to next part
 	 */
 	efm = skip_to_option_part(efm + len);	/* skip comma and spaces */
     }
     if (fmt_first == NULL)	/* nothing found */
-    {
 	EMSG(_("E378: 'errorformat' contains no pattern"));
-	goto error2;
+
+    vim_free(fmtstr);
+    vim_free(lit);
+    return fmt_first;
+
+parse_efm_error:
+    free_efm_list(&fmt_first);
+    vim_free(fmtstr);
+    vim_free(lit);
+    return NULL;
+}
+
+/*
+ * Use the "*lit_len" characters in "lit" as the text that a line matching
+ * "fmt_ptr" must contain, if it is longer than what was found before.
+ * Resets "*lit_len" to zero.
+ */
+    static void
+efm_keep_must(fmt_ptr, lit, lit_len)
+    efm_T	*fmt_ptr;
+    char_u	*lit;
+    int		*lit_len;
+{
+    char_u	*p;
+
+    if (*lit_len > 0 && (fmt_ptr->must == NULL
+			       || *lit_len > (int)STRLEN(fmt_ptr->must)))
+    {
+	p = vim_strnsave(lit, *lit_len);
+	if (p != NULL)
+	{
+	    vim_free(fmt_ptr->must);
+	    fmt_ptr->must = p;
+	}
+    }
+    *lit_len = 0;
+}
+
+/*
+ * Free the efm_T list "*fmt_first" and set it to NULL.
+ */
+    static void
+free_efm_list(fmt_first)
+    efm_T	**fmt_first;
+{
+    efm_T	*fmt_ptr;
+
+    for (fmt_ptr = *fmt_first; fmt_ptr != NULL; fmt_ptr = *fmt_first)
+    {
+	*fmt_first = fmt_ptr->next;
+	vim_regfree(fmt_ptr->prog);
+	vim_free(fmt_ptr->must);
+	vim_free(fmt_ptr);
+    }
+}
+
+/*
+ * Read the errorfile "efile" into memory, line by line, building the error
+ * list.
+ * Alternative: when "efile" is null read errors from buffer "buf".
+ * Always use 'errorformat' from "buf" if there is a local value.
+ * Then "lnumfirst" and "lnumlast" specify the range of lines to use.
+ * Set the title of the list to "qf_title".
+ * Return -1 for error, number of errors for success.
+ */
+    static int
+qf_init_ext(qi, efile, buf, tv, errorformat, newlist, lnumfirst, lnumlast,
+								     qf_title)
+    qf_info_T	    *qi;
+    char_u	    *efile;
+    buf_T	    *buf;
+    typval_T	    *tv;
+    char_u	    *errorformat;
+    int		    newlist;		/* TRUE: start a new error list */
+    linenr_T	    lnumfirst;		/* first line number to use */
+    linenr_T	    lnumlast;		/* last line number to use */
+    char_u	    *qf_title;
+{
+    char_u	    *namebuf;
+    char_u	    *errmsg;
+    char_u	    *pattern;
+    char_u	    *efm_str = NULL;
+    long	    efm_re = p_re;	/* 'regexpengine' for fmt_first */
+    int		    col = 0;
+    char_u	    use_viscol = FALSE;
+    int		    type = 0;
+    int		    valid;
+    linenr_T	    buflnum = lnumfirst;
+    long	    lnum = 0L;
+    int		    enr = 0;
+    FILE	    *fd = NULL;
+    qfline_T	    *qfprev = NULL;	/* init to make SASC shut up */
+    char_u	    *efmp;
+    efm_T	    *fmt_first = NULL;
+    efm_T	    *fmt_ptr;
+    efm_T	    *fmt_start = NULL;
+    char_u	    *efm;
+    char_u	    *ptr;
+    int		    len;
+    int		    i;
+    int		    idx = 0;
+    int		    multiline = FALSE;
+    int		    multiignore = FALSE;
+    int		    multiscan = FALSE;
+    int		    retval = -1;	/* default: return error flag */
+    char_u	    *directory = NULL;
+    char_u	    *currfile = NULL;
+    char_u	    *tail = NULL;
+    char_u	    *p_str = NULL;
+    listitem_T	    *p_li = NULL;
+    struct dir_stack_T  *file_stack = NULL;
+    regmatch_T	    regmatch;
+
+    namebuf = alloc(CMDBUFFSIZE + 1);
+    errmsg = alloc(CMDBUFFSIZE + 1);
+    pattern = alloc(CMDBUFFSIZE + 1);
+    if (namebuf == NULL || errmsg == NULL || pattern == NULL)
+	goto qf_init_end;
+
+    if (efile != NULL && (fd = mch_fopen((char *)efile, "r")) == NULL)
+    {
+	EMSG2(_(e_openerrf), efile);
+	goto qf_init_end;
+    }
+
+    if (newlist || qi->qf_curlist == qi->qf_listcount)
+	/* make place for a new list */
+	qf_new_list(qi, qf_title);
+    else if (qi->qf_lists[qi->qf_curlist].qf_count > 0)
+	/* Adding to existing list, find last entry. */
+	for (qfprev = qi->qf_lists[qi->qf_curlist].qf_start;
+			  qfprev->qf_next != qfprev; qfprev = qfprev->qf_next)
+	    ;
+
+    /* Use the local value of 'errorformat' if it's set. */
+    if (errorformat == p_efm && tv == NULL && *buf->b_p_efm != NUL)
+	efm = buf->b_p_efm;
+    else
+	efm = errorformat;
+    if (qf_efm_cache != NULL && STRCMP(qf_efm_cache_str, efm) == 0
+						    && qf_efm_cache_re == p_re)
+    {
+	/* 'errorformat' didn't change since the last time, use the compiled
+	 * patterns.  Take them out of the cache while using them, an
+	 * autocommand may cause this function to be called recursively. */
+	fmt_first = qf_efm_cache;
+	efm_str = qf_efm_cache_str;
+	efm_re = qf_efm_cache_re;
+	qf_efm_cache = NULL;
+	qf_efm_cache_str = NULL;
+    }
+    else
+    {
+	fmt_first = parse_efm_option(efm, errmsg);
+	if (fmt_first == NULL)
+	    goto error2;
+	efm_str = vim_strsave(efm);
     }
 
     /*
@@ -606,6 +745,11 @@ restofline:
 	    type = 0;
 	    tail = NULL;
 
+	    /* Quickly skip a line that doesn't contain the literal text of
+	     * the pattern. */
+	    if (fmt_ptr->must != NULL
+		    && strstr((char *)IObuff, (char *)fmt_ptr->must) == NULL)
+		continue;
 	    regmatch.regprog = fmt_ptr->prog;
 	    if (vim_regexec(&regmatch, IObuff, (colnr_T)0))
 	    {
@@ -782,9 +926,12 @@ restofline:
 		    qfprev->qf_col = col;
 		qfprev->qf_viscol = use_viscol;
 		if (!qfprev->qf_fnum)
+		{
 		    qfprev->qf_fnum = qf_get_fnum(directory,
 					*namebuf || directory ? namebuf
 					  : currfile && valid ? currfile : 0);
+		    qf_buf_has_entry(qi, qfprev->qf_fnum);
+		}
 		if (idx == 'Z')
 		    multiline = multiignore = FALSE;
 		line_breakcheck();
@@ -864,11 +1011,19 @@ error2:
 qf_init_ok:
     if (fd != NULL)
 	fclose(fd);
-    for (fmt_ptr = fmt_first; fmt_ptr != NULL; fmt_ptr = fmt_first)
+    if (fmt_first != NULL && efm_str != NULL)
     {
-	fmt_first = fmt_ptr->next;
-	vim_regfree(fmt_ptr->prog);
-	vim_free(fmt_ptr);
+	/* Keep the compiled patterns for the next time. */
+	free_efm_list(&qf_efm_cache);
+	vim_free(qf_efm_cache_str);
+	qf_efm_cache = fmt_first;
+	qf_efm_cache_str = efm_str;
+	qf_efm_cache_re = efm_re;
+    }
+    else
+    {
+	free_efm_list(&fmt_first);
+	vim_free(efm_str);
     }
     qf_clean_dir_stack(&dir_stack);
     qf_clean_dir_stack(&file_stack);
@@ -876,7 +1031,6 @@ qf_init_end:
     vim_free(namebuf);
     vim_free(errmsg);
     vim_free(pattern);
-    vim_free(fmtstr);
 
 #ifdef FEAT_WINDOWS
     qf_update_buffer(qi);
@@ -974,9 +1128,16 @@ qf_free_all(wp)
 	ll_free_all(&wp->w_llist_ref);
     }
     else
+    {
 	/* quickfix list */
 	for (i = 0; i < qi->qf_listcount; ++i)
 	    qf_free(qi, i);
+
+	/* compiled 'errorformat' */
+	free_efm_list(&qf_efm_cache);
+	vim_free(qf_efm_cache_str);
+	qf_efm_cache_str = NULL;
+    }
 }
 
 /*
@@ -1008,6 +1169,7 @@ qf_add_entry(qi, prevp, dir, fname, bufnum, mesg, lnum, col, vis_col, pattern,
 	qfp->qf_fnum = bufnum;
     else
 	qfp->qf_fnum = qf_get_fnum(dir, fname);
+    qf_buf_has_entry(qi, qfp->qf_fnum);
     if ((qfp->qf_text = vim_strsave(mesg)) == NULL)
     {
 	vim_free(qfp);
@@ -1181,6 +1343,7 @@ copy_loclist(from, to)
 		 * field is copied here.
 		 */
 		prevp->qf_fnum = from_qfp->qf_fnum; /* file number */
+		qf_buf_has_entry(to->w_llist, prevp->qf_fnum);
 		prevp->qf_type = from_qfp->qf_type; /* error type */
 		if (from_qfl->qf_ptr == from_qfp)
 		    to_qfl->qf_ptr = prevp;	    /* current location */
@@ -1250,6 +1413,22 @@ qf_get_fnum(directory, fname)
     }
 }
 
+/*
+ * Remember that buffer "fnum" has an entry in quickfix list "qi", so that
+ * qf_mark_adjust() only needs to go over the entries for such buffers.
+ */
+    static void
+qf_buf_has_entry(qi, fnum)
+    qf_info_T	*qi;
+    int		fnum;
+{
+    buf_T	*buf;
+
+    if (fnum != 0 && (buf = buflist_findnr(fnum)) != NULL)
+	buf->b_has_qf_entry |= qi == &ql_info ? BUF_HAS_QF_ENTRY
+							  : BUF_HAS_LL_ENTRY;
+}
+
 /*
  * push dirbuf onto the directory stack and return pointer to actual dir or
  * NULL on error
@@ -2191,13 +2370,17 @@ qf_mark_adjust(wp, line1, line2, amount, amount_after)
     qfline_T	*qfp;
     int		idx;
     qf_info_T	*qi = &ql_info;
+    int		found_one = FALSE;
 
     if (wp != NULL)
     {
-	if (wp->w_llist == NULL)
+	if (wp->w_llist == NULL
+			   || !(curbuf->b_has_qf_entry & BUF_HAS_LL_ENTRY))
 	    return;
 	qi = wp->w_llist;
     }
+    else if (!(curbuf->b_has_qf_entry & BUF_HAS_QF_ENTRY))
+	return;
 
     for (idx = 0; idx < qi->qf_listcount; ++idx)
 	if (qi->qf_lists[idx].qf_count)
@@ -2205,6 +2388,7 @@ qf_mark_adjust(wp, line1, line2, amount, amount_after)
 		       i < qi->qf_lists[idx].qf_count; ++i, qfp = qfp->qf_next)
 		if (qfp->qf_fnum == curbuf->b_fnum)
 		{
+		    found_one = TRUE;
 		    if (qfp->qf_lnum >= line1 && qfp->qf_lnum <= line2)
 		    {
 			if (amount == MAXLNUM)
@@ -2215,6 +2399,11 @@ qf_mark_adjust(wp, line1, line2, amount, amount_after)
 		    else if (amount_after && qfp->qf_lnum > line2)
 			qfp->qf_lnum += amount_after;
 		}
+
+    /* The quickfix list no longer has entries for this buffer.  Location
+     * lists are not checked, another window may still have one. */
+    if (!found_one && wp == NULL)
+	curbuf->b_has_qf_entry &= ~BUF_HAS_QF_ENTRY;
 }
 
 /*
@@ -731,8 +731,39 @@ typedef struct matchinf_S
     /* for NOBREAK */
     int		mi_result2;		/* "mi_resul" without following word */
     char_u	*mi_end2;		/* "mi_end" without following word */
+
+    char_u	*mi_kend;		/* last byte of the checked text looked
+					   at for keep-case words */
 } matchinf_T;
 
+/*
+ * Cache with the results of spell_check() for recently checked words, so
+ * that redrawing text doesn't check the same words again and again.
+ * An entry is only used when the text that was looked at is the same, for
+ * the same window settings and when nothing changed in the spelling tables
+ * since it was stored.  When two words map to the same entry the last one
+ * wins.
+ */
+#define SPELL_CACHE_SIZE 1024	/* number of entries, power of two */
+#define SPELL_CACHE_WLEN 44	/* max length of text in an entry */
+
+typedef struct spellcache_S
+{
+    synblock_T	*sc_block;	/* spelling settings used, NULL if unused */
+    int		sc_gen;		/* value of spell_cache_gen when stored */
+    short	sc_result;	/* value returned by spell_check() */
+    short	sc_attr;	/* highlight for bad word, -1 for none */
+    char_u	sc_capcheck;	/* checked for a missing capital */
+    char_u	sc_textlen;	/* number of bytes in sc_text[] */
+    char_u	sc_text[SPELL_CACHE_WLEN];  /* text that was looked at, ends
+					       in a NUL at the end of the
+					       line */
+} spellcache_T;
+
+static spellcache_T *spell_cache = NULL;
+static int	    spell_cache_gen = 0;    /* incremented to invalidate all
+					       entries */
+
 /*
  * The tables used for recognizing word characters according to spelling.
  * These are only used for the first 256 characters of 'encoding'.
@@ -846,6 +877,7 @@ static void slang_free __ARGS((slang_T *lp));
 static void slang_clear __ARGS((slang_T *lp));
 static void slang_clear_sug __ARGS((slang_T *lp));
 static void find_word __ARGS((matchinf_T *mip, int mode));
+static spellcache_T *spell_cache_entry __ARGS((win_T *wp, char_u *text, int len, int capcheck));
 static int match_checkcompoundpattern __ARGS((char_u *ptr, int wlen, garray_T *gap));
 static int can_compound __ARGS((slang_T *slang, char_u *word, char_u *flags));
 static int can_be_compound __ARGS((trystate_T *sp, slang_T *slang, char_u *compflags, int flag));
@@ -1029,6 +1061,9 @@ spell_check(wp, ptr, attrp, capcol, docount)
     int		wrongcaplen = 0;
     int		lpi;
     int		count_word = docount;
+    spellcache_T *sc = NULL;
+    char_u	*fend;
+    char_u	*p;
 
     /* A word never starts at a space or a control character.  Return quickly
      * then, skipping over the character. */
@@ -1087,10 +1122,25 @@ spell_check(wp, ptr, attrp, capcol, docount)
      * for the word end. */
     if (*mi.mi_fend != NUL)
 	mb_ptr_adv(mi.mi_fend);
+    fend = mi.mi_fend;
+
+    /* Use the result of checking the same text before. */
+    if (!docount && nrlen == 0 && spell_iswordp_nmw(ptr, wp))
+    {
+	sc = spell_cache_entry(wp, ptr, (int)(fend - ptr) + (*fend == NUL),
+							    wrongcaplen > 0);
+	if (sc != NULL && sc->sc_block != NULL)
+	{
+	    if (sc->sc_attr >= 0)
+		*attrp = (hlf_T)sc->sc_attr;
+	    return sc->sc_result;
+	}
+    }
 
     (void)spell_casefold(ptr, (int)(mi.mi_fend - ptr), mi.mi_fword,
 							     MAXWLEN + 1);
     mi.mi_fwordlen = (int)STRLEN(mi.mi_fword);
+    mi.mi_kend = ptr;
 
     /* The word is bad unless we recognize it. */
     mi.mi_result = SP_BAD;
@@ -1211,6 +1261,40 @@ spell_check(wp, ptr, attrp, capcol, docount)
 	    *attrp = HLF_SPL;
     }
 
+    /* Store the result in the cache, together with all the text that was
+     * looked at: what was case-folded, what was matched with keep-case words
+     * and the character after a 'midword' character at the end of the word.
+     * Including the NUL at the end of the line. */
+    if (sc != NULL)
+    {
+	p = mi.mi_fend;
+	if (p == fend && *p != NUL && (p[-1] >= 0x80
+					    || wp->w_s->b_spell_ismw[p[-1]]))
+	    mb_ptr_adv(p);
+	if (*p == NUL)
+	    ++p;
+	if (mi.mi_kend >= p || p - ptr > SPELL_CACHE_WLEN)
+	    sc = NULL;
+    }
+    if (sc != NULL)
+    {
+	sc->sc_block = wp->w_s;
+	sc->sc_gen = spell_cache_gen;
+	sc->sc_capcheck = wrongcaplen > 0;
+	sc->sc_textlen = (int)(p - ptr);
+	mch_memmove(sc->sc_text, ptr, (size_t)sc->sc_textlen);
+	if (wrongcaplen > 0 && (mi.mi_result == SP_OK || mi.mi_result == SP_RARE))
+	{
+	    sc->sc_result = wrongcaplen;
+	    sc->sc_attr = HLF_SPC;
+	}
+	else
+	{
+	    sc->sc_result = (int)(mi.mi_end - ptr);
+	    sc->sc_attr = mi.mi_result == SP_OK ? -1 : *attrp;
+	}
+    }
+
     if (wrongcaplen > 0 && (mi.mi_result == SP_OK || mi.mi_result == SP_RARE))
     {
 	/* Report SpellCap only when the word isn't badly spelled. */
@@ -1221,6 +1305,44 @@ spell_check(wp, ptr, attrp, capcol, docount)
     return (int)(mi.mi_end - ptr);
 }
 
+/*
+ * Find the spell_check() cache entry for the word and the non-word character
+ * after it, "len" bytes of "text", in window "wp".  "capcheck" is TRUE when
+ * checking for a missing capital.
+ * Returns NULL when the text can't be cached.  Otherwise the entry to be
+ * used; its sc_block is NULL when the result isn't known yet.
+ */
+    static spellcache_T *
+spell_cache_entry(wp, text, len, capcheck)
+    win_T	*wp;
+    char_u	*text;
+    int		len;
+    int		capcheck;
+{
+    spellcache_T	*sc;
+    unsigned		hash = 0;
+    int			i;
+
+    if (len > SPELL_CACHE_WLEN)
+	return NULL;
+    if (spell_cache == NULL)
+    {
+	spell_cache = (spellcache_T *)alloc_clear(
+			      (unsigned)(SPELL_CACHE_SIZE * sizeof(spellcache_T)));
+	if (spell_cache == NULL)
+	    return NULL;
+    }
+    for (i = 0; i < len; ++i)
+	hash = hash * 101 + text[i];
+    sc = &spell_cache[(hash + capcheck) & (SPELL_CACHE_SIZE - 1)];
+    if (sc->sc_block != wp->w_s
+	    || sc->sc_gen != spell_cache_gen
+	    || sc->sc_capcheck != capcheck
+	    || STRNCMP(sc->sc_text, text, sc->sc_textlen) != 0)
+	sc->sc_block = NULL;
+    return sc;
+}
+
 /*
  * Check if the word at "mip->mi_word" is in the tree.
  * When "mode" is FIND_FOLDWORD check in fold-case word tree.
@@ -1382,6 +1504,9 @@ find_word(mip, mode)
 	    }
 	}
     }
+    if ((mode == FIND_KEEPWORD || mode == FIND_KEEPCOMPOUND)
+						&& ptr + wlen > mip->mi_kend)
+	mip->mi_kend = ptr + wlen;
 
     /*
      * Verify that one of the possible endings is valid.  Try the longest
@@ -2606,6 +2731,8 @@ slang_clear(lp)
     int		i;
     int		round;
 
+    ++spell_cache_gen;
+
     vim_free(lp->sl_fbyts);
     lp->sl_fbyts = NULL;
     vim_free(lp->sl_kbyts);
@@ -4224,6 +4351,7 @@ did_set_spelllang(wp)
     if (recursive)
 	return NULL;
     recursive = TRUE;
+    ++spell_cache_gen;
 
     ga_init2(&ga, sizeof(langp_T), 2);
     clear_midword(wp);
@@ -4508,6 +4636,7 @@ did_set_spelllang(wp)
 theend:
     vim_free(spl_copy);
     recursive = FALSE;
+    ++spell_cache_gen;
     redraw_win_later(wp, NOT_VALID);
     return ret_msg;
 }
@@ -4747,6 +4876,9 @@ spell_free_all()
     repl_to = NULL;
     vim_free(repl_from);
     repl_from = NULL;
+
+    vim_free(spell_cache);
+    spell_cache = NULL;
 }
 #endif
 
@@ -9696,6 +9828,7 @@ init_spell_chartab()
 
     did_set_spelltab = FALSE;
     clear_spell_chartab(&spelltab);
+    ++spell_cache_gen;
 #ifdef FEAT_MBYTE
     if (enc_dbcs)
     {
@@ -10110,10 +10243,15 @@ spell_casefold(str, len, buf, buflen)
 
 static int sps_flags = SPS_BEST;	/* flags from 'spellsuggest' */
 static int sps_limit = 9999;		/* max nr of suggestions given */
+static long sps_timeout = 0;		/* msec for finding suggestions */
+#ifdef FEAT_RELTIME
+static proftime_T sps_time_limit;	/* when to stop finding suggestions */
+#endif
+static int sps_timed_out = FALSE;	/* stopped finding suggestions */
 
 /*
  * Check the 'spellsuggest' option.  Return FAIL if it's wrong.
- * Sets "sps_flags" and "sps_limit".
+ * Sets "sps_flags", "sps_limit" and "sps_timeout".
  */
     int
 spell_check_sps()
@@ -10125,6 +10263,7 @@ spell_check_sps()
 
     sps_flags = 0;
     sps_limit = 9999;
+    sps_timeout = 0;
 
     for (p = p_sps; *p != NUL; )
     {
@@ -10144,6 +10283,18 @@ spell_check_sps()
 	    f = SPS_FAST;
 	else if (STRCMP(buf, "double") == 0)
 	    f = SPS_DOUBLE;
+	else if (STRNCMP(buf, "timeout:", 8) == 0)
+	{
+	    s = buf + 8;
+	    if (!VIM_ISDIGIT(*s) && !(*s == '-' && VIM_ISDIGIT(s[1])))
+		f = -1;
+	    else
+	    {
+		sps_timeout = getdigits(&s);
+		if (*s != NUL)
+		    f = -1;
+	    }
+	}
 	else if (STRNCMP(buf, "expr:", 5) != 0
 		&& STRNCMP(buf, "file:", 5) != 0)
 	    f = -1;
@@ -10152,6 +10303,7 @@ spell_check_sps()
 	{
 	    sps_flags = SPS_BEST;
 	    sps_limit = 9999;
+	    sps_timeout = 0;
 	    return FAIL;
 	}
 	if (f != 0)
@@ -10253,7 +10405,12 @@ spell_suggest(count)
 							TRUE, need_cap, TRUE);
 
     if (sug.su_ga.ga_len == 0)
-	MSG(_("Sorry, no suggestions"));
+    {
+	if (sps_timed_out)
+	    MSG(_("Sorry, no suggestions found before the timeout"));
+	else
+	    MSG(_("Sorry, no suggestions"));
+    }
     else if (count > 0)
     {
 	if (count > sug.su_ga.ga_len)
@@ -10290,6 +10447,9 @@ spell_suggest(count)
 	}
 #endif
 	msg_puts(IObuff);
+	/* Tell the user the list may be incomplete. */
+	if (sps_timed_out)
+	    msg_puts_attr((char_u *)_(" (timed out)"), hl_attr(HLF_W));
 	msg_clr_eos();
 	msg_putchar('\n');
 
@@ -10621,11 +10781,13 @@ spell_find_suggest(badptr, badlen, su, maxcount, banbadword, need_cap, interacti
     int		c;
     int		i;
     langp_T	*lp;
+    int		did_intern = FALSE;
 
     /*
      * Set the info in "*su".
      */
     vim_memset(su, 0, sizeof(suginfo_T));
+    sps_timed_out = FALSE;	/* set by spell_suggest_intern() */
     ga_init2(&su->su_ga, (int)sizeof(suggest_T), 10);
     ga_init2(&su->su_sga, (int)sizeof(suggest_T), 10);
     if (*badptr == NUL)
@@ -10712,12 +10874,14 @@ spell_find_suggest(badptr, badlen, su, maxcount, banbadword, need_cap, interacti
 	else if (STRNCMP(buf, "file:", 5) == 0)
 	    /* Use list of suggestions in a file. */
 	    spell_suggest_file(su, buf + 5);
-	else
+	else if (!did_intern)
 	{
-	    /* Use internal method. */
+	    /* Use internal method, once.  Also for items such as a number,
+	     * searching again would only take time. */
 	    spell_suggest_intern(su, interactive);
 	    if (sps_flags & SPS_DOUBLE)
 		do_combine = TRUE;
+	    did_intern = TRUE;
 	}
     }
 
@@ -10835,9 +10999,19 @@ spell_suggest_intern(su, interactive)
     int		interactive;
 {
     /*
-     * Load the .sug file(s) that are available and not done yet.
+     * Load the .sug file(s) that are available and not done yet.  They are
+     * only used for sound-a-like words, not when "fast" is used.  Avoids
+     * keeping the soundfold tree and word table in memory.
      */
-    suggest_load_files();
+    if ((sps_flags & SPS_FAST) == 0)
+	suggest_load_files();
+
+    /* Stop going through the word trees when it takes too long, use the
+     * suggestions found so far.  Loading the .sug files isn't included. */
+#ifdef FEAT_RELTIME
+    if (sps_timeout > 0)
+	profile_setlimit(sps_timeout, &sps_time_limit);
+#endif
 
     /*
      * 1. Try special cases, such as repeating a word: "the the" -> "the".
@@ -11437,7 +11611,7 @@ suggest_trie_walk(su, lp, fword, soundfold)
      * - When a state is done go to the next, set "ts_state".
      * - When all states are tried decrease "depth".
      */
-    while (depth >= 0 && !got_int)
+    while (depth >= 0 && !got_int && !sps_timed_out)
     {
 	sp = &stack[depth];
 	switch (sp->ts_state)
@@ -12788,6 +12962,10 @@ suggest_trie_walk(su, lp, fword, soundfold)
 	    {
 		ui_breakcheck();
 		breakcheckcount = 1000;
+#ifdef FEAT_RELTIME
+		if (sps_timeout > 0 && profile_passed_limit(&sps_time_limit))
+		    sps_timed_out = TRUE;
+#endif
 	    }
 	}
     }
@@ -317,6 +317,8 @@ struct u_entry
     linenr_T	ue_lcount;	/* linecount when u_save called */
     char_u	**ue_array;	/* array of lines in undo block */
     long	ue_size;	/* number of lines in ue_array */
+    long	ue_maxsize;	/* allocated size of ue_array when lines were
+				   added to it, otherwise zero */
 #ifdef U_DEBUG
     int		ue_magic;	/* magic number to check allocation */
 #endif
@@ -1331,6 +1333,21 @@ typedef struct {
 } synblock_T;
 
 
+/*
+ * Entry of a buffer in one of the buffer indexes, see buf_index_add().
+ * Buffers with the same key are linked with bi_next.
+ */
+#define BUFINDEX_KEYLEN	40	/* room for "dev:ino" in hex */
+typedef struct bufindex_S bufindex_T;
+struct bufindex_S
+{
+    char_u	bi_key[BUFINDEX_KEYLEN]; /* key in the hashtable, empty when
+					    not in the index */
+    buf_T	*bi_buf;	/* buffer this entry is part of */
+    bufindex_T	*bi_next;	/* next buffer with the same key */
+};
+
+
 /*
  * buffer: structure that holds information about one file
  *
@@ -1384,6 +1401,12 @@ struct file_buffer
 
     int		b_fnum;		/* buffer number for this file. */
 
+    bufindex_T	b_nr_index;	/* entry in the buffer number index */
+    bufindex_T	b_name_index;	/* entry in the file name index */
+#ifdef UNIX
+    bufindex_T	b_ino_index;	/* entry in the dev/inode index */
+#endif
+
     int		b_changed;	/* 'modified': Set to TRUE if something in the
 				   file has been changed and not written out. */
     int		b_changedtick;	/* incremented for each change, also for undo */
@@ -1442,6 +1465,9 @@ struct file_buffer
     /* Table used for mappings local to a buffer. */
     mapblock_T	*(b_maphash[256]);
 
+    /* Number of local mappings for each {lhs}, see getchar.c. */
+    hashtab_T	b_maplhs;
+
     /* First abbreviation local to a buffer. */
     mapblock_T	*b_first_abbr;
 #endif
@@ -1776,6 +1802,13 @@ struct file_buffer
     signlist_T	*b_signlist;	/* list of signs to draw */
 #endif
 
+#ifdef FEAT_QUICKFIX
+    int		b_has_qf_entry;	/* BUF_HAS_ flags: buffer may have an entry
+				   in the quickfix list or a location list */
+# define BUF_HAS_QF_ENTRY 1
+# define BUF_HAS_LL_ENTRY 2
+#endif
+
 #ifdef FEAT_NETBEANS_INTG
     int		b_netbeans_file;    /* TRUE when buffer is owned by NetBeans */
     int		b_was_netbeans_file;/* TRUE if b_netbeans_file was once set */
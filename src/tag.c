@@ -37,6 +37,7 @@ typedef struct tag_pointers
 /*
  * The matching tags are first stored in ga_match[].  In which one depends on
  * the priority of the match.
+ * ht_match[] is used to find duplicates, ga_match[] to keep them in sequence.
  * At the end, the matches from ga_match[] are concatenated, to make a list
  * sorted on priority.
  */
@@ -53,6 +54,11 @@ typedef struct tag_pointers
 #define MT_MASK		7		/* mask for printing priority */
 #define MT_COUNT	16
 
+/* In a match the file name and the line are separated with TAG_SEP while
+ * finding matches, so that it can be used as a hashtab key.  Changed to a NUL
+ * when the matches are returned. */
+#define TAG_SEP		0x02
+
 static char	*mt_names[MT_COUNT/2] =
 		{"FSC", "F C", "F  ", "FS ", " SC", "  C", "   ", " S "};
 
@@ -1190,6 +1196,55 @@ tag_strnicmp(s1, s2, len)
     }
     return 0;				/* strings match */
 }
+
+static off_t tag_char_offset __ARGS((FILE *fp, off_t filesize, int c, char_u *lbuf));
+
+/*
+ * For a tags file that is sorted on byte value: use a binary search to find
+ * the offset of the first line that starts with byte "c" or a higher value.
+ * Returns "filesize" when there is no such line.
+ * "lbuf" must be LSIZE bytes, it is used to read lines.
+ */
+    static off_t
+tag_char_offset(fp, filesize, c, lbuf)
+    FILE	*fp;
+    off_t	filesize;
+    int		c;
+    char_u	*lbuf;
+{
+    off_t	low = 0;	    /* lines before "low" start below "c" */
+    off_t	high = filesize;    /* search for a line start before this */
+    off_t	found = filesize;   /* first line found starting with "c" or
+				       higher */
+    off_t	mid;
+    off_t	pos;
+
+    while (low < high)
+    {
+	mid = low + (high - low) / 2;
+
+	/* Find the start of the first line at or after "mid". */
+#ifdef HAVE_FSEEKO
+	fseeko(fp, mid > low ? mid - 1 : low, SEEK_SET);
+#else
+	fseek(fp, (long)(mid > low ? mid - 1 : low), SEEK_SET);
+#endif
+	if (mid > low)
+	    (void)tag_fgets(lbuf, LSIZE, fp);
+	pos = ftell(fp);
+
+	if (pos >= found || tag_fgets(lbuf, LSIZE, fp))
+	    high = mid;		    /* no line starts after "mid" */
+	else if (*lbuf >= c)
+	{
+	    found = pos;
+	    high = mid;
+	}
+	else
+	    low = ftell(fp);
+    }
+    return found;
+}
 #endif
 
 /*
@@ -1307,6 +1362,14 @@ find_tags(pat, num_matches, matchesp, flags, mincount, buf_ffname)
 	int	low_char;	/* first char at low_offset */
 	int	high_char;	/* first char at high_offset */
     } search_info;
+    struct tag_char_range	/* Lines to search when ignoring case */
+    {
+	int	chars[2];	/* first byte of the lines to search */
+	int	count;		/* number of used items in chars[] */
+	int	idx;		/* index in chars[] of current lines */
+	int	done;		/* already did this for the current file */
+	int	match_count;	/* match_count when starting */
+    } char_range;
     off_t	filesize;
     int		tagcmp;
     off_t	offset;
@@ -1347,12 +1410,10 @@ find_tags(pat, num_matches, matchesp, flags, mincount, buf_ffname)
     int		is_etag;		/* current file is emaces style */
 #endif
 
-    struct match_found
-    {
-	int	len;		/* nr of chars of match[] to be compared */
-	char_u	match[1];	/* actually longer */
-    } *mfp, *mfp2;
-    garray_T	ga_match[MT_COUNT];
+    char_u	*mfp;
+    garray_T	ga_match[MT_COUNT];	/* stores matches in sequence */
+    hashtab_T	ht_match[MT_COUNT];	/* stores matches by key */
+    hash_T	hash = 0;
     int		match_count = 0;		/* number of matches found */
     char_u	**matches;
     int		mtt;
@@ -1402,7 +1463,10 @@ find_tags(pat, num_matches, matchesp, flags, mincount, buf_ffname)
     ebuf = alloc(LSIZE);
 #endif
     for (mtt = 0; mtt < MT_COUNT; ++mtt)
-	ga_init2(&ga_match[mtt], (int)sizeof(struct match_found *), 100);
+    {
+	ga_init2(&ga_match[mtt], (int)sizeof(char_u *), 100);
+	hash_init(&ht_match[mtt]);
+    }
 
     /* check for out of memory situation */
     if (lbuf == NULL || tag_fname == NULL
@@ -1456,6 +1520,11 @@ find_tags(pat, num_matches, matchesp, flags, mincount, buf_ffname)
     /* This is only to avoid a compiler warning for using search_info
      * uninitialised. */
     vim_memset(&search_info, 0, (size_t)1);
+    char_range.count = 0;
+    char_range.idx = 0;
+    char_range.done = FALSE;
+    char_range.match_count = 0;
+    filesize = 0;
 #endif
 
     /*
@@ -1686,6 +1755,10 @@ find_tags(pat, num_matches, matchesp, flags, mincount, buf_ffname)
 
 		if (eof)
 		{
+#ifdef FEAT_TAG_BINS
+		    if (char_range.count > 0)
+			goto char_range_end;
+#endif
 #ifdef FEAT_EMACS_TAGS
 		    if (incstack_idx)	/* this was an included file */
 		    {
@@ -1701,6 +1774,40 @@ find_tags(pat, num_matches, matchesp, flags, mincount, buf_ffname)
 #endif
 			break;			    /* end of file */
 		}
+
+#ifdef FEAT_TAG_BINS
+		/*
+		 * When only searching the lines starting with a specific
+		 * character: after the last one continue with the lines for
+		 * the next character, or stop.
+		 */
+		if (char_range.count > 0
+			   && *lbuf != char_range.chars[char_range.idx])
+		{
+		    if (++char_range.idx >= char_range.count)
+		    {
+char_range_end:
+			/* Nothing found in those lines: Search the whole
+			 * file, an old style static tag "file.c:tag" doesn't
+			 * start with the tag name, and the file may not be
+			 * sorted after all. */
+			char_range.count = 0;
+			if (match_count != char_range.match_count)
+			    break;
+			rewind(fp);
+			state = TS_START;
+			continue;
+		    }
+		    offset = tag_char_offset(fp, filesize,
+				    char_range.chars[char_range.idx], lbuf);
+# ifdef HAVE_FSEEKO
+		    fseeko(fp, offset, SEEK_SET);
+# else
+		    fseek(fp, (long)offset, SEEK_SET);
+# endif
+		    continue;
+		}
+#endif
 	    }
 line_read_in:
 
@@ -1874,6 +1981,49 @@ line_read_in:
 		    linear = TRUE;
 		    state = TS_LINEAR;
 		}
+
+		/*
+		 * When ignoring case in a tags file that is sorted on byte
+		 * value, only the lines starting with the first character of
+		 * the tag in upper or lower case can match.  Find them with a
+		 * binary search instead of reading the whole file.
+		 */
+		if (state == TS_LINEAR && tag_file_sorted == '1' && p_tbs
+			&& !char_range.done && orgpat.regmatch.rm_ic && orgpat.headlen > 0
+			&& orgpat.head[0] > '!' && orgpat.head[0] < 0x80
+# ifdef FEAT_MBYTE
+			&& vimconv.vc_type == CONV_NONE
+# endif
+# ifdef FEAT_CSCOPE
+			&& !use_cscope
+# endif
+			&& (filesize = lseek(fileno(fp),
+						   (off_t)0L, SEEK_END)) > 0)
+		{
+		    lseek(fileno(fp), (off_t)0L, SEEK_SET);
+		    char_range.count = 0;
+		    char_range.idx = 0;
+		    char_range.done = TRUE;
+		    char_range.match_count = match_count;
+		    if (ASCII_ISALPHA(orgpat.head[0]))
+		    {
+			/* Upper case sorts before lower case. */
+			char_range.chars[char_range.count++] =
+						   TOUPPER_ASC(orgpat.head[0]);
+			char_range.chars[char_range.count++] =
+						   TOLOWER_ASC(orgpat.head[0]);
+		    }
+		    else
+			char_range.chars[char_range.count++] = orgpat.head[0];
+		    offset = tag_char_offset(fp, filesize,
+						    char_range.chars[0], lbuf);
+# ifdef HAVE_FSEEKO
+		    fseeko(fp, offset, SEEK_SET);
+# else
+		    fseek(fp, (long)offset, SEEK_SET);
+# endif
+		    continue;
+		}
 #else
 		state = TS_LINEAR;
 #endif
@@ -2266,16 +2416,12 @@ parse_line:
 			 */
 			*tagp.tagname_end = NUL;
 			len = (int)(tagp.tagname_end - tagp.tagname);
-			mfp = (struct match_found *)
-				 alloc((int)sizeof(struct match_found) + len
-							     + 10 + ML_EXTRA);
+			mfp = alloc((unsigned)len + 10 + ML_EXTRA + 1);
 			if (mfp != NULL)
 			{
-			    /* "len" includes the language and the NUL, but
-			     * not the priority. */
-			    mfp->len = len + ML_EXTRA + 1;
-#define ML_HELP_LEN 6
-			    p = mfp->match;
+			    /* The priority goes after the NUL, thus it's not
+			     * part of the key. */
+			    p = mfp;
 			    STRCPY(p, tagp.tagname);
 #ifdef FEAT_MULTI_LANG
 			    p[len] = '@';
@@ -2306,14 +2452,9 @@ parse_line:
 			    if (tagp.command + 2 < temp_end)
 			    {
 				len = (int)(temp_end - tagp.command - 2);
-				mfp = (struct match_found *)alloc(
-					(int)sizeof(struct match_found) + len);
+				mfp = alloc((unsigned)len + 1);
 				if (mfp != NULL)
-				{
-				    mfp->len = len + 1; /* include the NUL */
-				    p = mfp->match;
-				    vim_strncpy(p, tagp.command + 2, len);
-				}
+				    vim_strncpy(mfp, tagp.command + 2, len);
 			    }
 			    else
 				mfp = NULL;
@@ -2322,14 +2463,9 @@ parse_line:
 			else
 			{
 			    len = (int)(tagp.tagname_end - tagp.tagname);
-			    mfp = (struct match_found *)alloc(
-				       (int)sizeof(struct match_found) + len);
+			    mfp = alloc((unsigned)len + 1);
 			    if (mfp != NULL)
-			    {
-				mfp->len = len + 1; /* include the NUL */
-				p = mfp->match;
-				vim_strncpy(p, tagp.tagname, len);
-			    }
+				vim_strncpy(mfp, tagp.tagname, len);
 
 			    /* if wanted, re-read line to get long form too */
 			    if (State & INSERT)
@@ -2339,9 +2475,11 @@ parse_line:
 		    else
 		    {
 			/* Save the tag in a buffer.
-			 * Emacs tag: <mtt><tag_fname><NUL><ebuf><NUL><lbuf>
-			 * other tag: <mtt><tag_fname><NUL><NUL><lbuf>
-			 * without Emacs tags: <mtt><tag_fname><NUL><lbuf>
+			 * Use one more than "mtt", a zero would end the key.
+			 * Emacs tag: <mtt><tag_fname><SEP><ebuf><SEP><lbuf>
+			 * other tag: <mtt><tag_fname><SEP><SEP><lbuf>
+			 * without Emacs tags: <mtt><tag_fname><SEP><lbuf>
+			 * The SEP is changed to a NUL at the end.
 			 */
 			len = (int)STRLEN(tag_fname)
 						 + (int)STRLEN(lbuf) + 3;
@@ -2351,28 +2489,26 @@ parse_line:
 			else
 			    ++len;
 #endif
-			mfp = (struct match_found *)alloc(
-				       (int)sizeof(struct match_found) + len);
+			mfp = alloc((unsigned)len);
 			if (mfp != NULL)
 			{
-			    mfp->len = len;
-			    p = mfp->match;
-			    p[0] = mtt;
+			    p = mfp;
+			    p[0] = mtt + 1;
 			    STRCPY(p + 1, tag_fname);
 #ifdef BACKSLASH_IN_FILENAME
 			    /* Ignore differences in slashes, avoid adding
 			     * both path/file and path\file. */
 			    slash_adjust(p + 1);
 #endif
-			    s = p + 1 + STRLEN(tag_fname) + 1;
+			    s = p + 1 + STRLEN(tag_fname);
+			    *s++ = TAG_SEP;
 #ifdef FEAT_EMACS_TAGS
 			    if (is_etag)
 			    {
 				STRCPY(s, ebuf);
-				s += STRLEN(ebuf) + 1;
+				s += STRLEN(ebuf);
 			    }
-			    else
-				*s++ = NUL;
+			    *s++ = TAG_SEP;
 #endif
 			    STRCPY(s, lbuf);
 			}
@@ -2380,34 +2516,33 @@ parse_line:
 
 		    if (mfp != NULL)
 		    {
+			hashitem_T	*hi;
+
 			/*
 			 * Don't add identical matches.
-			 * This can take a lot of time when finding many
-			 * matches, check for CTRL-C now and then.
 			 * Add all cscope tags, because they are all listed.
+			 * The key ends at the first NUL, for help tags this
+			 * leaves out the priority.
 			 */
 #ifdef FEAT_CSCOPE
 			if (use_cscope)
-			    i = -1;
+			    hi = NULL;
 			else
 #endif
-			  for (i = ga_match[mtt].ga_len; --i >= 0 && !got_int; )
-			  {
-			      mfp2 = ((struct match_found **)
-						  (ga_match[mtt].ga_data))[i];
-			      if (mfp2->len == mfp->len
-				      && vim_memcmp(mfp2->match, mfp->match,
-						       (size_t)mfp->len) == 0)
-				  break;
-			      line_breakcheck();
-			  }
-			if (i < 0)
 			{
-			    ((struct match_found **)(ga_match[mtt].ga_data))
+			    hash = hash_hash(mfp);
+			    hi = hash_lookup(&ht_match[mtt], mfp, hash);
+			}
+			if (hi == NULL || HASHITEM_EMPTY(hi))
+			{
+			    if (hi != NULL)
+				hash_add_item(&ht_match[mtt], hi, mfp, hash);
+			    ((char_u **)(ga_match[mtt].ga_data))
 					       [ga_match[mtt].ga_len++] = mfp;
 			    ++match_count;
 			}
 			else
+			    /* duplicate tag, drop it */
 			    vim_free(mfp);
 		    }
 		}
@@ -2454,6 +2589,8 @@ parse_line:
 
 #ifdef FEAT_TAG_BINS
 	tag_file_sorted = NUL;
+	char_range.count = 0;
+	char_range.done = FALSE;
 	if (sort_error)
 	{
 	    EMSG2(_("E432: Tags file not sorted: %s"), tag_fname);
@@ -2529,20 +2666,32 @@ findtag_end:
     {
 	for (i = 0; i < ga_match[mtt].ga_len; ++i)
 	{
-	    mfp = ((struct match_found **)(ga_match[mtt].ga_data))[i];
+	    mfp = ((char_u **)(ga_match[mtt].ga_data))[i];
 	    if (matches == NULL)
 		vim_free(mfp);
 	    else
 	    {
-		/* To avoid allocating memory again we turn the struct
-		 * match_found into a string.  For help the priority was not
-		 * included in the length. */
-		mch_memmove(mfp, mfp->match,
-			 (size_t)(mfp->len + (help_only ? ML_HELP_LEN : 0)));
-		matches[match_count++] = (char_u *)mfp;
+		if (!name_only && !help_only)
+		{
+		    /* Change mtt back to zero-based and the TAG_SEP back to a
+		     * NUL. */
+		    *mfp = *mfp - 1;
+		    p = vim_strchr(mfp + 1, TAG_SEP);
+		    if (p != NULL)
+		    {
+			*p = NUL;
+#ifdef FEAT_EMACS_TAGS
+			p = vim_strchr(p + 1, TAG_SEP);
+			if (p != NULL)
+			    *p = NUL;
+#endif
+		    }
+		}
+		matches[match_count++] = mfp;
 	    }
 	}
 	ga_clear(&ga_match[mtt]);
+	hash_clear(&ht_match[mtt]);
     }
 
     *matchesp = matches;
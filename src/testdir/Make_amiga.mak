@@ -42,7 +42,14 @@ SCRIPTS = test1.out test3.out test4.out test5.out test6.out \
 		test_listlbr_utf8.out \
 		test_qf_title.out \
 		test_eval.out \
-		test_options.out
+		test_options.out \
+		test_tagcase.out \
+		test_system.out \
+		test_bufcase.out \
+		test_globbraces.out \
+		test_spellsps.out \
+		test_rtpwild.out \
+		test_spellcache.out
 
 .SUFFIXES: .in .out
 
@@ -173,3 +180,10 @@ test_listlbr_utf8.out: test_listlbr_utf8.in
 test_qf_title.out: test_qf_title.in
 test_eval.out: test_eval.in
 test_options.out: test_options.in
+test_tagcase.out: test_tagcase.in
+test_system.out: test_system.in
+test_bufcase.out: test_bufcase.in
+test_globbraces.out: test_globbraces.in
+test_spellsps.out: test_spellsps.in
+test_rtpwild.out: test_rtpwild.in
+test_spellcache.out: test_spellcache.in
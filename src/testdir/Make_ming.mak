@@ -61,7 +61,14 @@ SCRIPTS =	test3.out test4.out test5.out test6.out test7.out \
 		test_listlbr_utf8.out \
 		test_qf_title.out \
 		test_eval.out \
-		test_options.out
+		test_options.out \
+		test_tagcase.out \
+		test_system.out \
+		test_bufcase.out \
+		test_globbraces.out \
+		test_spellsps.out \
+		test_rtpwild.out \
+		test_spellcache.out
 
 SCRIPTS32 =	test50.out test70.out
 
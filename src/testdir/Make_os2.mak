@@ -43,7 +43,14 @@ SCRIPTS = test1.out test3.out test4.out test5.out test6.out \
 		test_listlbr.out \
 		test_listlbr_utf8.out \
 		test_qf_title.out \
-		test_options.out
+		test_options.out \
+		test_tagcase.out \
+		test_system.out \
+		test_bufcase.out \
+		test_globbraces.out \
+		test_spellsps.out \
+		test_rtpwild.out \
+		test_spellcache.out
 
 .SUFFIXES: .in .out
 
@@ -964,6 +964,7 @@ extern char *(*dyn_libintl_textdomain)(const char *domainname);
 #define SHELL_SILENT	16	/* don't print error returned by command */
 #define SHELL_READ	32	/* read lines and insert into buffer */
 #define SHELL_WRITE	64	/* write lines from buffer */
+#define SHELL_OUTPUT	128	/* read output through a pipe (Unix only) */
 
 /* Values returned by mch_nodetype() */
 #define NODE_NORMAL	0	/* file or directory, check with mch_isdir()*/